@@ -0,0 +1,109 @@
+// The MIT License (MIT)
+//
+// Copyright (c) Darrell Wright
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and / or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include "impl/daw_csv_table.h"
+#include "impl/daw_text_table_link_common.h"
+#include "impl/daw_text_table_link_table_state.h"
+
+#include <daw/daw_string_view.h>
+
+#include <cstddef>
+#include <iterator>
+#include <string_view>
+
+namespace daw::text_data {
+	/***
+	 * The position of a batch parse in a table.  The header is read when the
+	 * cursor is constructed and each call to parse_rows continues from the
+	 * row after the last one it filled
+	 * @tparam T type of row with a text_data_contract
+	 */
+	template<typename T, typename TableType = basic_csv_table_type<char>>
+	class csv_row_cursor {
+		using CharT = typename TableType::CharT;
+		using parser_t = text_table_details::text_table_data_contract_trait_t<T>;
+		using location_type = typename parser_t::template location_type<TableType>;
+		static_assert( text_table_details::check_arena_container<parser_t>( ) );
+
+		TableState<TableType> m_state;
+		location_type m_loc_info;
+
+	public:
+		using value_type = T;
+
+		explicit constexpr csv_row_cursor( std::basic_string_view<CharT> data,
+		                                   TableType const &table = TableType{} )
+		  : m_state( daw::basic_string_view<CharT>( data.data( ), data.size( ) ),
+		             table )
+		  , m_loc_info( parser_t::template location_info<TableType>( m_state ) ) {}
+
+		/***
+		 * Parse up to count rows into out, assigning over the existing values
+		 * @return the number of rows parsed, less than count only at the end of
+		 * the table
+		 */
+		constexpr std::size_t parse_rows( T *out, std::size_t count ) {
+			std::size_t result = 0;
+			for( ; result < count and not m_state.at_eof( ); ++result ) {
+				out[result] = parser_t::template parse_row<T>( m_state, m_loc_info );
+			}
+			return result;
+		}
+
+		[[nodiscard]] constexpr bool at_end( ) const {
+			return m_state.at_eof( );
+		}
+
+		/***
+		 * The rows that have not been parsed yet
+		 */
+		[[nodiscard]] constexpr std::basic_string_view<CharT> remaining( ) const {
+			auto const rng = m_state.remaining( );
+			return std::basic_string_view<CharT>( rng.data( ), rng.size( ) );
+		}
+	};
+
+	/***
+	 * Fill [first, last) with the next rows of the table
+	 * @return the number of rows parsed, less than last - first only at the end
+	 * of the table
+	 */
+	template<typename T, typename TableType>
+	constexpr std::size_t parse_rows( csv_row_cursor<T, TableType> &cursor,
+	                                  T *first, T *last ) {
+		return cursor.parse_rows( first, static_cast<std::size_t>( last - first ) );
+	}
+
+	/***
+	 * Fill a contiguous buffer of rows, e.g. a std::array or a std::vector that
+	 * is reused between batches, with the next rows of the table
+	 * @return the number of rows parsed, less than the size of out only at the
+	 * end of the table
+	 */
+	template<typename T, typename TableType, typename Buffer>
+	constexpr std::size_t parse_rows( csv_row_cursor<T, TableType> &cursor,
+	                                  Buffer &out ) {
+		return cursor.parse_rows( std::data( out ), std::size( out ) );
+	}
+} // namespace daw::text_data
@@ -0,0 +1,327 @@
+// The MIT License (MIT)
+//
+// Copyright (c) Darrell Wright
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and / or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include "daw_text_table_link.h"
+#include "impl/daw_csv_table.h"
+#include "impl/daw_text_table_link_common.h"
+#include "impl/daw_text_table_link_parsers.h"
+#include "impl/daw_text_table_link_table_state.h"
+
+#include <daw/daw_string_view.h>
+
+#include <cstddef>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace daw::text_data {
+	/***
+	 * The cells of a string column stored back to back.  Cell n is
+	 * [offsets[n], offsets[n + 1]) of the character buffer
+	 */
+	template<typename CharT>
+	class string_column {
+		std::vector<CharT> m_chars{};
+		std::vector<std::size_t> m_offsets = std::vector<std::size_t>( 1U, 0U );
+
+	public:
+		using value_type = std::basic_string_view<CharT>;
+
+		string_column( ) = default;
+
+		void push_back( std::basic_string_view<CharT> cell ) {
+			m_chars.insert( m_chars.end( ), cell.begin( ), cell.end( ) );
+			m_offsets.push_back( m_chars.size( ) );
+		}
+
+		/***
+		 * Append a cell without its escapes
+		 */
+		template<typename TableType>
+		void push_back_unescaped( daw::basic_string_view<CharT> cell,
+		                          TableType const &table ) {
+			auto const pos = m_chars.size( );
+			m_chars.resize( pos + cell.size( ) );
+			m_chars.resize( pos + text_table_details::unescape_cell(
+			                        cell, table, m_chars.data( ) + pos ) );
+			m_offsets.push_back( m_chars.size( ) );
+		}
+
+		void reserve( std::size_t rows ) {
+			m_offsets.reserve( rows + 1U );
+		}
+
+		[[nodiscard]] value_type operator[]( std::size_t idx ) const {
+			return value_type( m_chars.data( ) + m_offsets[idx],
+			                   m_offsets[idx + 1U] - m_offsets[idx] );
+		}
+
+		[[nodiscard]] std::size_t size( ) const {
+			return m_offsets.size( ) - 1U;
+		}
+
+		[[nodiscard]] bool empty( ) const {
+			return size( ) == 0;
+		}
+
+		[[nodiscard]] std::vector<CharT> const &chars( ) const {
+			return m_chars;
+		}
+
+		[[nodiscard]] std::vector<std::size_t> const &offsets( ) const {
+			return m_offsets;
+		}
+	};
+
+	namespace text_table_details {
+		template<typename TextTableColumn>
+		inline constexpr bool is_string_column_v = std::disjunction_v<
+		  std::is_same<typename TextTableColumn::column_type,
+		               TextTableParserTypes::String>,
+		  std::is_same<typename TextTableColumn::column_type,
+		               TextTableParserTypes::StringRaw>,
+		  std::is_same<typename TextTableColumn::column_type,
+		               TextTableParserTypes::StringArena>,
+		  std::is_same<typename TextTableColumn::column_type,
+		               TextTableParserTypes::StringView>>;
+
+		/***
+		 * Placeholder so that the storage of the other columns keeps their index
+		 */
+		struct ignored_column {
+			constexpr void reserve( std::size_t ) const {}
+		};
+
+		template<typename TextTableColumn, typename CharT, typename = void>
+		struct column_storage_type {
+			using type =
+			  std::conditional_t<is_string_column_v<TextTableColumn>,
+			                     string_column<CharT>,
+			                     std::vector<typename TextTableColumn::parse_to>>;
+		};
+
+		template<typename TextTableColumn, typename CharT>
+		struct column_storage_type<
+		  TextTableColumn, CharT,
+		  std::enable_if_t<is_ignored_column_v<TextTableColumn>>> {
+			using type = ignored_column;
+		};
+
+		template<typename TextTableColumn, typename CharT>
+		using column_storage_t =
+		  typename column_storage_type<TextTableColumn, CharT>::type;
+
+		template<typename TextTableColumn, std::size_t N, typename TableType,
+		         typename LocationInfo, typename Column>
+		constexpr void append_cell( LocationInfo const &loc_info, Column &column,
+		                            TableType const &table ) {
+			auto const cell = loc_info[N].location;
+			if constexpr( is_ignored_column_v<TextTableColumn> ) {
+				(void)cell;
+				(void)column;
+				(void)table;
+			} else if constexpr( is_string_column_v<TextTableColumn> ) {
+				if( is_unescaping_column_v<TextTableColumn> and loc_info[N].escaped ) {
+					column.push_back_unescaped( cell, table );
+				} else {
+					column.push_back( std::basic_string_view<typename TableType::CharT>(
+					  cell.data( ), cell.size( ) ) );
+				}
+			} else {
+				column.push_back(
+				  parse_cell<TextTableColumn, N, LocationInfo, TableType>( loc_info,
+				                                                           table ) );
+			}
+		}
+
+		template<typename ColumnList, typename CharT>
+		struct column_storage;
+
+		template<header_match Match, typename... TextTableColumns, typename CharT>
+		struct column_storage<basic_text_column_list<Match, TextTableColumns...>,
+		                      CharT> {
+			using type = std::tuple<column_storage_t<TextTableColumns, CharT>...>;
+
+			static void reserve( type &columns, std::size_t rows ) {
+				std::apply( [rows]( auto &...column ) { ( column.reserve( rows ), ... ); },
+				            columns );
+			}
+
+			template<typename TableType, std::size_t... Is>
+			static constexpr void
+			parse_row( TableState<TableType> &state,
+			           locations_info_t<CharT, TextTableColumns...> &loc_info,
+			           type &columns, std::index_sequence<Is...> ) {
+				read_row_cells( state, loc_info );
+				( append_cell<TextTableColumns, Is, TableType>(
+				    loc_info, std::get<Is>( columns ), state.table( ) ),
+				  ... );
+				state.row_move_to_next( );
+			}
+
+			template<typename TableType>
+			static constexpr void
+			parse_row( TableState<TableType> &state,
+			           locations_info_t<CharT, TextTableColumns...> &loc_info,
+			           type &columns ) {
+				parse_row( state, loc_info, columns,
+				           std::index_sequence_for<TextTableColumns...>{} );
+			}
+		};
+	} // namespace text_table_details
+
+	/***
+	 * A table stored as one contiguous array per mapped column.  Numeric
+	 * columns are a std::vector of their parse_to type, string columns are
+	 * a string_column and ignored columns are an empty ignored_column
+	 * @tparam T type with a text_data_contract describing the columns
+	 */
+	template<typename T, typename CharT = char>
+	class csv_columns {
+		using storage_t = text_table_details::column_storage<
+		  text_table_details::text_table_data_contract_trait_t<T>, CharT>;
+
+		typename storage_t::type m_columns{};
+		std::size_t m_size = 0;
+
+		template<typename U, typename TableType>
+		friend csv_columns<U, typename TableType::CharT>
+		parse_csv_columns_impl(
+		  daw::basic_string_view<typename TableType::CharT> rng,
+		  TableType const &table );
+
+	public:
+		csv_columns( ) = default;
+
+		/***
+		 * The column at index Idx of the text_column_list
+		 */
+		template<std::size_t Idx>
+		[[nodiscard]] auto const &column( ) const {
+			return std::get<Idx>( m_columns );
+		}
+
+		[[nodiscard]] typename storage_t::type const &columns( ) const {
+			return m_columns;
+		}
+
+		[[nodiscard]] std::size_t size( ) const {
+			return m_size;
+		}
+
+		[[nodiscard]] bool empty( ) const {
+			return m_size == 0;
+		}
+	};
+
+	template<typename T, typename TableType>
+	[[maybe_unused, nodiscard]] csv_columns<T, typename TableType::CharT>
+	parse_csv_columns_impl(
+	  daw::basic_string_view<typename TableType::CharT> rng,
+	  TableType const &table ) {
+		using CharT = typename TableType::CharT;
+		using parser_t = text_table_details::text_table_data_contract_trait_t<T>;
+		using storage_t = text_table_details::column_storage<parser_t, CharT>;
+
+		auto state = TableState<TableType>( rng, table );
+		auto loc_info = parser_t::template location_info<TableType>( state );
+
+		auto result = csv_columns<T, CharT>( );
+		storage_t::reserve(
+		  result.m_columns,
+		  table_row_count_impl<TableType>( state.remaining( ), table ) );
+		while( not state.at_eof( ) ) {
+			storage_t::parse_row( state, loc_info, result.m_columns );
+			++result.m_size;
+		}
+		return result;
+	}
+
+	/***
+	 * Parse a csv table into one array per column instead of a container of T
+	 * @tparam T type with a text_data_contract describing the columns
+	 */
+	template<typename T>
+	[[maybe_unused, nodiscard]] csv_columns<T, char>
+	parse_csv_columns( std::basic_string_view<char> rng ) {
+		return parse_csv_columns_impl<T>(
+		  daw::basic_string_view<char>( rng.data( ), rng.size( ) ),
+		  basic_csv_table_type<char>{} );
+	}
+
+	template<typename T>
+	[[maybe_unused, nodiscard]] csv_columns<T, wchar_t>
+	parse_csv_columns( std::basic_string_view<wchar_t> rng ) {
+		return parse_csv_columns_impl<T>(
+		  daw::basic_string_view<wchar_t>( rng.data( ), rng.size( ) ),
+		  basic_csv_table_type<wchar_t>{} );
+	}
+
+	/***
+	 * Parse a table into one array per column using a dialect other than
+	 * comma separated values
+	 * @param dialect a text_dialect such as tsv_dialect{} or a runtime_dialect
+	 */
+	template<typename T, typename Dialect,
+	         std::enable_if_t<text_table_details::is_dialect_v<Dialect>,
+	                          std::nullptr_t> = nullptr>
+	[[maybe_unused, nodiscard]] csv_columns<T, char>
+	parse_csv_columns( std::basic_string_view<char> rng,
+	                   Dialect const &dialect ) {
+		return parse_csv_columns_impl<T>(
+		  daw::basic_string_view<char>( rng.data( ), rng.size( ) ),
+		  basic_dialect_table_type<char, Dialect>( dialect ) );
+	}
+
+	template<typename T, typename Dialect,
+	         std::enable_if_t<text_table_details::is_dialect_v<Dialect>,
+	                          std::nullptr_t> = nullptr>
+	[[maybe_unused, nodiscard]] csv_columns<T, wchar_t>
+	parse_csv_columns( std::basic_string_view<wchar_t> rng,
+	                   Dialect const &dialect ) {
+		return parse_csv_columns_impl<T>(
+		  daw::basic_string_view<wchar_t>( rng.data( ), rng.size( ) ),
+		  basic_dialect_table_type<wchar_t, Dialect>( dialect ) );
+	}
+
+	/***
+	 * Parse a table into one array per column with an explicit table type,
+	 * e.g. one without a header row
+	 * @param table a basic_csv_table_type such as
+	 * basic_csv_table_type<char, NoHeaderRow>
+	 */
+	template<typename T, typename TableType,
+	         std::enable_if_t<text_table_details::is_a_table_type_v<TableType>,
+	                          std::nullptr_t> = nullptr>
+	[[maybe_unused, nodiscard]] csv_columns<T, typename TableType::CharT>
+	parse_csv_columns( std::basic_string_view<typename TableType::CharT> rng,
+	                   TableType const &table ) {
+		return parse_csv_columns_impl<T>(
+		  daw::basic_string_view<typename TableType::CharT>( rng.data( ),
+		                                                     rng.size( ) ),
+		  table );
+	}
+} // namespace daw::text_data
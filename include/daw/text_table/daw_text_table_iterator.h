@@ -26,26 +26,23 @@
 #include "impl/daw_text_table_link_common.h"
 #include "impl/daw_text_table_link_table_state.h"
 
+#include <cstddef>
 #include <optional>
+#include <string_view>
+#include <type_traits>
 #include <utility>
 
 namespace daw::text_data {
-	namespace text_data_details {
-		template<typename T>
-		struct arrow_proxy {
-			T value;
-
-			[[nodiscard]] constexpr T *operator->( ) {
-				return &value;
-			}
-		};
-	} // namespace text_data_details
-
+	/***
+	 * Iterate over the rows of a table.  A row is parsed at most once, on the
+	 * first dereference, and rows that are not dereferenced are skipped
+	 * without being parsed
+	 */
 	template<typename T, typename TableType>
 	struct basic_text_table_iterator {
 		using value_type = T;
-		using reference = value_type;
-		using pointer = text_data_details::arrow_proxy<value_type>;
+		using reference = value_type const &;
+		using pointer = value_type const *;
 		using difference_type = std::ptrdiff_t;
 		using iterator_category = std::forward_iterator_tag;
 		using CharT = typename TableType::CharT;
@@ -53,34 +50,242 @@ namespace daw::text_data {
 	private:
 		using parser_t = text_table_details::text_table_data_contract_trait_t<T>;
 		using location_type = typename parser_t::template location_type<TableType>;
+		static_assert( text_table_details::check_arena_container<parser_t>( ) );
 
+		daw::basic_string_view<CharT> m_data{};
+		// Always at the start of the current row
 		TableState<TableType> m_state{daw::basic_string_view<CharT>( )};
-		std::optional<location_type> m_loc_info{};
-		std::optional<TableState<TableType>> m_last_state{};
+		mutable std::optional<location_type> m_loc_info{};
+		mutable std::optional<value_type> m_value{};
+		// The start of the next row once the current row has been parsed
+		mutable std::optional<TableState<TableType>> m_next_state{};
 
 	public:
 		constexpr basic_text_table_iterator( ) = default;
-		constexpr basic_text_table_iterator( std::basic_string_view<CharT> data )
-		  : m_state( TableState<TableType>(
-		      daw::basic_string_view<CharT>( data.data( ), data.size( ) ) ) )
+		constexpr basic_text_table_iterator( std::basic_string_view<CharT> data,
+		                                     TableType const &table = TableType{} )
+		  : m_data( data.data( ), data.size( ) )
+		  , m_state( TableState<TableType>( m_data, table ) )
 		  , m_loc_info( parser_t::location_info( m_state ) ) {}
 
-		constexpr value_type operator*( ) {
-			if( not m_last_state ) {
-				m_last_state = m_state;
-				return parser_t::template parse_row<T>( m_state, *m_loc_info );
+		/***
+		 * Move to a data row of the table using a row_index built from it
+		 */
+		template<typename RowIndex>
+		constexpr basic_text_table_iterator &seek_row( RowIndex const &index,
+		                                               std::size_t row ) {
+			m_state.seek_row( m_data, index, row );
+			m_value.reset( );
+			m_next_state.reset( );
+			return *this;
+		}
+
+		constexpr reference operator*( ) const {
+			if( not m_value ) {
+				auto row_state = m_state;
+				m_value.emplace(
+				  parser_t::template parse_row<T>( row_state, *m_loc_info ) );
+				m_next_state = row_state;
+			}
+			return *m_value;
+		}
+
+		constexpr pointer operator->( ) const {
+			return &operator*( );
+		}
+
+		constexpr basic_text_table_iterator &operator++( ) {
+			if( m_next_state ) {
+				m_state = *m_next_state;
+				m_next_state.reset( );
+			} else {
+				m_state.row_move_to_next( );
+			}
+			m_value.reset( );
+			return *this;
+		}
+
+		constexpr basic_text_table_iterator operator++( int ) {
+			auto result = *this;
+			(void)operator++( );
+			return result;
+		}
+
+		[[nodiscard]] explicit constexpr operator bool( ) const {
+			return m_state.at_eof( );
+		}
+
+		constexpr bool operator==( basic_text_table_iterator const &rhs ) const {
+			return m_state == rhs.m_state;
+		}
+
+		constexpr bool operator!=( basic_text_table_iterator const &rhs ) const {
+			return m_state != rhs.m_state;
+		}
+	};
+
+	/***
+	 * A row of a table whose cells have been found but not parsed.  A cell is
+	 * parsed each time it is accessed, so columns that are never accessed only
+	 * cost finding their bounds.  The cells refer to the table data
+	 * @tparam T type of row with a text_data_contract
+	 */
+	template<typename T, typename TableType = basic_csv_table_type<char>>
+	class csv_row_view {
+		using parser_t = text_table_details::text_table_data_contract_trait_t<T>;
+		using location_type = typename parser_t::template location_type<TableType>;
+		using CharT = typename TableType::CharT;
+
+		location_type m_loc_info;
+		TableType m_table;
+
+		template<typename, typename>
+		friend struct basic_text_table_iterator;
+
+		constexpr csv_row_view( location_type const &loc_info,
+		                        TableType const &table )
+		  : m_loc_info( loc_info )
+		  , m_table( table ) {}
+
+		/***
+		 * Find the cells of the row that state is at the start of and move state
+		 * to the next row
+		 */
+		constexpr void read_row( TableState<TableType> &state ) {
+			text_table_details::read_row_cells( state, m_loc_info );
+			state.row_move_to_next( );
+		}
+
+	public:
+		static constexpr std::size_t column_count = parser_t::column_count;
+
+		template<std::size_t Idx>
+		using column_t = typename parser_t::template column_t<Idx>;
+
+		/***
+		 * The index of the column with the given name in the contract
+		 */
+		template<COLUMNNAMETYPE Name>
+		static constexpr std::size_t index_of =
+		  parser_t::template column_index<Name>;
+
+		/***
+		 * The text of a cell without its quotes but with any escapes
+		 */
+		template<std::size_t Idx>
+		[[nodiscard]] constexpr std::basic_string_view<CharT> cell( ) const {
+			static_assert( Idx < column_count, "Invalid column index" );
+			static_assert( not location_type::ignored[Idx],
+			               "Ignored columns are not read" );
+			auto const &location = m_loc_info[Idx].location;
+			return std::basic_string_view<CharT>( location.data( ),
+			                                      location.size( ) );
+		}
+
+		/***
+		 * Parse a cell as the column of the contract describes
+		 */
+		template<std::size_t Idx>
+		[[nodiscard]] constexpr typename column_t<Idx>::parse_to get( ) const {
+			static_assert( Idx < column_count, "Invalid column index" );
+			static_assert( not location_type::ignored[Idx],
+			               "Ignored columns are not read" );
+			static_assert( text_table_details::check_arena_columns<
+			               text_table_details::is_arena_column_v<column_t<Idx>>>( ) );
+			return text_table_details::parse_cell<column_t<Idx>, Idx,
+			                                      location_type, TableType>(
+			  m_loc_info, m_table );
+		}
+
+		/***
+		 * Parse the cell of the column with the given name
+		 */
+		template<COLUMNNAMETYPE Name>
+		[[nodiscard]] constexpr decltype( auto ) get( ) const {
+			static_assert( index_of<Name> != text_table_details::no_column_index,
+			               "Unknown column name" );
+			return get<index_of<Name>>( );
+		}
+
+		/***
+		 * Parse the whole row
+		 */
+		[[nodiscard]] constexpr T value( ) const {
+			static_assert( text_table_details::check_arena_container<parser_t>( ) );
+			return parser_t::template construct_row<T>( m_loc_info, m_table );
+		}
+	};
+
+	template<std::size_t Idx, typename T, typename TableType>
+	[[nodiscard]] constexpr decltype( auto )
+	get( csv_row_view<T, TableType> const &row ) {
+		return row.template get<Idx>( );
+	}
+
+	/***
+	 * Iterate over the rows of a table as csv_row_view's.  Dereferencing finds
+	 * the bounds of the mapped cells of the row in a single pass and the
+	 * cells are parsed when they are accessed.  The view is reused for each
+	 * row, a copy of it remains valid for as long as the table data
+	 */
+	template<typename T, typename TableType>
+	struct basic_text_table_iterator<csv_row_view<T, TableType>, TableType> {
+		using value_type = csv_row_view<T, TableType>;
+		using reference = value_type const &;
+		using pointer = value_type const *;
+		using difference_type = std::ptrdiff_t;
+		using iterator_category = std::forward_iterator_tag;
+		using CharT = typename TableType::CharT;
+
+	private:
+		using parser_t = text_table_details::text_table_data_contract_trait_t<T>;
+
+		daw::basic_string_view<CharT> m_data{};
+		// Always at the start of the current row
+		TableState<TableType> m_state{daw::basic_string_view<CharT>( )};
+		mutable std::optional<value_type> m_value{};
+		// The start of the next row once the cells of the current row are found
+		mutable std::optional<TableState<TableType>> m_next_state{};
+
+	public:
+		constexpr basic_text_table_iterator( ) = default;
+		constexpr basic_text_table_iterator( std::basic_string_view<CharT> data,
+		                                     TableType const &table = TableType{} )
+		  : m_data( data.data( ), data.size( ) )
+		  , m_state( TableState<TableType>( m_data, table ) )
+		  , m_value( value_type( parser_t::location_info( m_state ), table ) ) {}
+
+		/***
+		 * Move to a data row of the table using a row_index built from it
+		 */
+		template<typename RowIndex>
+		constexpr basic_text_table_iterator &seek_row( RowIndex const &index,
+		                                               std::size_t row ) {
+			m_state.seek_row( m_data, index, row );
+			m_next_state.reset( );
+			return *this;
+		}
+
+		constexpr reference operator*( ) const {
+			if( not m_next_state ) {
+				auto row_state = m_state;
+				m_value->read_row( row_state );
+				m_next_state = row_state;
 			}
-			m_state = *m_last_state;
-			return parser_t::template parse_row<T>( m_state, *m_loc_info );
+			return *m_value;
 		}
 
-		constexpr pointer operator->( ) {
-			return pointer{operator*( )};
+		constexpr pointer operator->( ) const {
+			return &operator*( );
 		}
 
 		constexpr basic_text_table_iterator &operator++( ) {
-			m_state.row_move_to_next( );
-			m_last_state.reset( );
+			if( m_next_state ) {
+				m_state = *m_next_state;
+				m_next_state.reset( );
+			} else {
+				m_state.row_move_to_next( );
+			}
 			return *this;
 		}
 
@@ -108,4 +313,24 @@ namespace daw::text_data {
 	         bool SkipLeadingWhiteSpace = false>
 	using csv_table_iterator = basic_text_table_iterator<
 	  T, basic_csv_table_type<CharT, HeaderRow, DataRow, SkipLeadingWhiteSpace>>;
+
+	/***
+	 * Iterate over the rows of a csv table as csv_row_view's
+	 */
+	template<typename T, typename CharT = char, std::size_t HeaderRow = 0,
+	         std::size_t DataRow = HeaderRow + 1U,
+	         bool SkipLeadingWhiteSpace = false>
+	using csv_row_view_iterator = basic_text_table_iterator<
+	  csv_row_view<T, basic_csv_table_type<CharT, HeaderRow, DataRow,
+	                                       SkipLeadingWhiteSpace>>,
+	  basic_csv_table_type<CharT, HeaderRow, DataRow, SkipLeadingWhiteSpace>>;
+
+	/***
+	 * Iterate over a table in the given dialect.  A runtime_dialect is passed
+	 * to the constructor as basic_dialect_table_type<CharT, runtime_dialect>(
+	 * dialect )
+	 */
+	template<typename T, typename Dialect, typename CharT = char>
+	using dialect_table_iterator =
+	  basic_text_table_iterator<T, basic_dialect_table_type<CharT, Dialect>>;
 } // namespace daw::text_data
@@ -26,12 +26,17 @@
 #include "impl/daw_csv_table.h"
 #include "impl/daw_text_table_link_common.h"
 #include "impl/daw_text_table_link_parsers.h"
+#include "impl/daw_text_table_structural.h"
 
 #include <daw/daw_string_view.h>
 #include <daw/daw_utility.h>
 
+#include <chrono>
 #include <cstddef>
 #include <cstdint>
+#include <ratio>
+#include <tuple>
+#include <type_traits>
 #include <vector>
 
 namespace daw::text_data {
@@ -58,6 +63,40 @@ namespace daw::text_data {
 		using parse_to = T;
 	};
 
+	/***
+	 * A point in time parsed straight from its text without locale or strptime
+	 * @tparam Format layout of the cells
+	 * @tparam T a std::chrono::time_point of the system_clock, or a type with a
+	 * duration member type that Constructor builds from a system_clock
+	 * time_point of that duration
+	 */
+	template<COLUMNNAMETYPE Name,
+	         timestamp_format Format = timestamp_format::Iso8601,
+	         typename T = std::chrono::time_point<std::chrono::system_clock,
+	                                              std::chrono::microseconds>,
+	         typename Constructor = daw::construct_a_t<T>>
+	struct text_timestamp {
+		using i_am_a_text_table_column = void;
+		static constexpr daw::string_view name = Name;
+		static constexpr timestamp_format format = Format;
+		using column_type = text_table_details::TextTableParserTypes::Date;
+		using parse_to = T;
+		using constructor = Constructor;
+	};
+
+	using timestamp_days =
+	  std::chrono::duration<std::int32_t, std::ratio<86400>>;
+
+	/***
+	 * A YYYY-MM-DD date as the time_point of its first instant
+	 */
+	template<COLUMNNAMETYPE Name,
+	         typename T = std::chrono::time_point<std::chrono::system_clock,
+	                                              timestamp_days>,
+	         typename Constructor = daw::construct_a_t<T>>
+	using text_date =
+	  text_timestamp<Name, timestamp_format::Date, T, Constructor>;
+
 	template<COLUMNNAMETYPE Name, typename T = std::string,
 	         typename Constructor = daw::construct_a_t<T>,
 	         typename Appender = text_table_details::basic_appender<T>>
@@ -79,16 +118,83 @@ namespace daw::text_data {
 		using constructor = Constructor;
 	};
 
-	template<COLUMNNAMETYPE Name>
+	/***
+	 * A view of the cell in the table data when it has no escapes.  Cells
+	 * with escapes, e.g. doubled quotes, are copied without them to the arena
+	 * of the result, so the Container must be an arena_vector
+	 */
+	template<COLUMNNAMETYPE Name, typename T = std::string_view,
+	         typename Constructor = daw::construct_a_t<T>>
+	struct text_string_view {
+		using i_am_a_text_table_column = void;
+		static constexpr daw::string_view name = Name;
+		using column_type = text_table_details::TextTableParserTypes::StringView;
+		using parse_to = T;
+		using constructor = Constructor;
+	};
+
+	/***
+	 * A string column that does not allocate per cell.  The characters are
+	 * copied, without escapes, into the arena of the result and
+	 * T views them, so the Container must be an arena_vector, e.g.
+	 * parse_csv_table<T, arena_vector<T>>( data ).  The views are valid for the
+	 * lifetime of that container.  Parsing into any other container, or
+	 * without one, e.g. with an iterator, does not compile
+	 */
+	template<COLUMNNAMETYPE Name, typename T = std::string_view,
+	         typename Constructor = daw::construct_a_t<T>>
+	struct text_string_arena {
+		using i_am_a_text_table_column = void;
+		static constexpr daw::string_view name = Name;
+		using column_type = text_table_details::TextTableParserTypes::StringArena;
+		using parse_to = T;
+		using constructor = Constructor;
+	};
+
+	/***
+	 * A column that is documented in the column list but not parsed.  It is
+	 * not passed to the constructor and does not need to be in the header
+	 */
+	template<COLUMNNAMETYPE Name = no_name>
 	struct text_table_ignored {
 		using i_am_a_text_table_column = void;
-		// TODO: future
-		daw::string_view name = Name;
+		static constexpr daw::string_view name = Name;
 		using column_type = text_table_details::TextTableParserTypes::Ignored;
 	};
 
-	template<typename... TextTableColumns>
-	struct text_column_list {
+	/***
+	 * Map a column by its zero based position in the row instead of by its
+	 * header name, e.g. text_column_at<3, text_number<no_name, int>>.  Tables
+	 * without a header row, NoHeaderRow, can only have positional columns and
+	 * when all columns are positional the row layout is known at compile time
+	 */
+	template<std::size_t Index, typename TextTableColumn>
+	struct text_column_at : TextTableColumn {
+		static constexpr std::size_t column_index = Index;
+	};
+
+	/***
+	 * The columns of a text_data_contract
+	 * @tparam Match how header cells are compared to the column names
+	 */
+	template<header_match Match, typename... TextTableColumns>
+	struct basic_text_column_list {
+		static constexpr header_match match = Match;
+		static constexpr std::size_t column_count = sizeof...( TextTableColumns );
+		// text_string_arena and text_string_view columns can only be parsed
+		// into an arena_vector
+		static constexpr bool has_arena_columns =
+		  ( text_table_details::is_arena_column_v<TextTableColumns> or ... );
+
+		template<std::size_t Idx>
+		using column_t =
+		  std::tuple_element_t<Idx, std::tuple<TextTableColumns...>>;
+
+		template<COLUMNNAMETYPE Name>
+		static constexpr std::size_t column_index =
+		  text_table_details::find_column_index<TextTableColumns...>(
+		    daw::string_view( Name ) );
+
 		template<typename TableType>
 		using location_type =
 		  text_table_details::locations_info_t<typename TableType::CharT,
@@ -97,7 +203,8 @@ namespace daw::text_data {
 		template<typename TableType>
 		[[nodiscard]] static constexpr location_type<TableType>
 		location_info( TableState<TableType> &state ) {
-			return text_table_details::fill_location_info<TextTableColumns...>(
+			return text_table_details::fill_location_info<Match,
+			                                              TextTableColumns...>(
 			  state );
 		}
 
@@ -109,17 +216,35 @@ namespace daw::text_data {
 			return text_table_details::parse_table_row<T, TextTableColumns...>(
 			  state, loc_info, std::index_sequence_for<TextTableColumns...>{} );
 		}
-	}; // namespace daw::text_data
+
+		/***
+		 * Construct a T from the cells that have already been read into loc_info
+		 */
+		template<typename T, typename TableType>
+		[[nodiscard]] static constexpr T construct_row(
+		  text_table_details::locations_info_t<typename TableType::CharT,
+		                                       TextTableColumns...> const &loc_info,
+		  TableType const &table ) {
+			return text_table_details::construct_row<T, TextTableColumns...>(
+			  loc_info, table, std::index_sequence_for<TextTableColumns...>{} );
+		}
+	};
+
+	template<typename... TextTableColumns>
+	using text_column_list =
+	  basic_text_column_list<header_match::Exact, TextTableColumns...>;
 
 	template<typename T, typename Container, typename Constructor,
-	         typename Appender, typename CharT>
+	         typename Appender, typename TableType>
 	[[maybe_unused, nodiscard]] constexpr Container
-	parse_csv_table_impl( daw::basic_string_view<CharT> rng ) {
-		using table_type = basic_csv_table_type<CharT>;
+	parse_csv_table_impl( daw::basic_string_view<typename TableType::CharT> rng,
+	                      TableType const &table ) {
 		using parser_t = text_table_details::text_table_data_contract_trait_t<T>;
+		static_assert(
+		  text_table_details::check_arena_container<parser_t, Container>( ) );
 
-		auto state = TableState<table_type>( rng );
-		auto loc_info = parser_t::template location_info<table_type>( state );
+		auto state = TableState<TableType>( rng, table );
+		auto loc_info = parser_t::template location_info<TableType>( state );
 
 		auto result = Constructor{}( );
 		auto appender = Appender( result );
@@ -136,7 +261,8 @@ namespace daw::text_data {
 	[[maybe_unused, nodiscard]] constexpr Container
 	parse_csv_table( std::basic_string_view<char> rng ) {
 		return parse_csv_table_impl<T, Container, Constructor, Appender>(
-		  daw::basic_string_view<char>( rng.data( ), rng.size( ) ) );
+		  daw::basic_string_view<char>( rng.data( ), rng.size( ) ),
+		  basic_csv_table_type<char>{} );
 	}
 
 	template<typename T, typename Container = std::vector<T>,
@@ -145,14 +271,195 @@ namespace daw::text_data {
 	[[maybe_unused, nodiscard]] constexpr Container
 	parse_csv_table( std::basic_string_view<wchar_t> rng ) {
 		return parse_csv_table_impl<T, Container, Constructor, Appender>(
-		  daw::basic_string_view<wchar_t>( rng.data( ), rng.size( ) ) );
+		  daw::basic_string_view<wchar_t>( rng.data( ), rng.size( ) ),
+		  basic_csv_table_type<wchar_t>{} );
 	}
 
-	template<typename TableType, typename CharT>
-	[[maybe_unused, nodiscard]] constexpr std::size_t
-	table_row_count_impl( daw::basic_string_view<CharT> rng ) {
+	/***
+	 * Parse a table using a dialect other than comma separated values
+	 * @param dialect a text_dialect such as tsv_dialect{} or a runtime_dialect
+	 */
+	template<typename T, typename Container = std::vector<T>,
+	         typename Constructor = daw::construct_a_t<Container>,
+	         typename Appender = text_table_details::basic_appender<Container>,
+	         typename Dialect,
+	         std::enable_if_t<text_table_details::is_dialect_v<Dialect>,
+	                          std::nullptr_t> = nullptr>
+	[[maybe_unused, nodiscard]] constexpr Container
+	parse_csv_table( std::basic_string_view<char> rng, Dialect const &dialect ) {
+		return parse_csv_table_impl<T, Container, Constructor, Appender>(
+		  daw::basic_string_view<char>( rng.data( ), rng.size( ) ),
+		  basic_dialect_table_type<char, Dialect>( dialect ) );
+	}
 
-		auto state = TableState<TableType>( rng );
+	template<typename T, typename Container = std::vector<T>,
+	         typename Constructor = daw::construct_a_t<Container>,
+	         typename Appender = text_table_details::basic_appender<Container>,
+	         typename Dialect,
+	         std::enable_if_t<text_table_details::is_dialect_v<Dialect>,
+	                          std::nullptr_t> = nullptr>
+	[[maybe_unused, nodiscard]] constexpr Container
+	parse_csv_table( std::basic_string_view<wchar_t> rng,
+	                 Dialect const &dialect ) {
+		return parse_csv_table_impl<T, Container, Constructor, Appender>(
+		  daw::basic_string_view<wchar_t>( rng.data( ), rng.size( ) ),
+		  basic_dialect_table_type<wchar_t, Dialect>( dialect ) );
+	}
+
+	/***
+	 * Parse a table with an explicit table type, e.g. one without a header row
+	 * @param table a basic_csv_table_type such as
+	 * basic_csv_table_type<char, NoHeaderRow>
+	 */
+	template<typename T, typename Container = std::vector<T>,
+	         typename Constructor = daw::construct_a_t<Container>,
+	         typename Appender = text_table_details::basic_appender<Container>,
+	         typename TableType,
+	         std::enable_if_t<text_table_details::is_a_table_type_v<TableType>,
+	                          std::nullptr_t> = nullptr>
+	[[maybe_unused, nodiscard]] constexpr Container
+	parse_csv_table( std::basic_string_view<typename TableType::CharT> rng,
+	                 TableType const &table ) {
+		return parse_csv_table_impl<T, Container, Constructor, Appender>(
+		  daw::basic_string_view<typename TableType::CharT>( rng.data( ),
+		                                                     rng.size( ) ),
+		  table );
+	}
+
+	template<typename T, std::size_t KeyIndex, typename Container,
+	         typename Constructor, typename Appender, typename TableType,
+	         typename Predicate>
+	[[maybe_unused, nodiscard]] constexpr Container parse_csv_table_if_impl(
+	  daw::basic_string_view<typename TableType::CharT> rng,
+	  TableType const &table, Predicate &&pred ) {
+		using parser_t = text_table_details::text_table_data_contract_trait_t<T>;
+		static_assert(
+		  text_table_details::check_arena_container<parser_t, Container>( ) );
+		using location_t = typename parser_t::template location_type<TableType>;
+		using CharT = typename TableType::CharT;
+		static_assert( KeyIndex < location_t::ignored.size( ),
+		               "KeyIndex must be the index of a column in the list" );
+		static_assert( not location_t::ignored[KeyIndex],
+		               "The key column cannot be ignored" );
+
+		auto state = TableState<TableType>( rng, table );
+		auto loc_info = parser_t::template location_info<TableType>( state );
+		auto const key_column = loc_info[KeyIndex].column;
+
+		auto result = Constructor{}( );
+		auto appender = Appender( result );
+
+		while( not state.at_eof( ) ) {
+			// Only the key cell is read until the row is known to be wanted
+			auto row_state = state;
+			row_state.column_skip( key_column );
+			auto const key = row_state.column_get_next( );
+			if( pred( std::basic_string_view<CharT>( key.data( ), key.size( ) ) ) ) {
+				appender( parser_t::template parse_row<T>( state, loc_info ) );
+			} else {
+				row_state.row_move_to_next( );
+				state = row_state;
+			}
+		}
+		return result;
+	}
+
+	/***
+	 * Parse the rows whose key cell satisfies pred.  Rows are rejected after
+	 * reading only the key cell, other cells are not read and T is not
+	 * constructed for them
+	 * @tparam KeyIndex index in the text_column_list of the key column
+	 * @param pred called with a std::string_view of the key cell as it is in
+	 * the table, without surrounding quotes and with any escapes
+	 */
+	template<typename T, std::size_t KeyIndex, typename Container = std::vector<T>,
+	         typename Constructor = daw::construct_a_t<Container>,
+	         typename Appender = text_table_details::basic_appender<Container>,
+	         typename Predicate>
+	[[maybe_unused, nodiscard]] constexpr Container
+	parse_csv_table_if( std::basic_string_view<char> rng, Predicate &&pred ) {
+		return parse_csv_table_if_impl<T, KeyIndex, Container, Constructor,
+		                               Appender>(
+		  daw::basic_string_view<char>( rng.data( ), rng.size( ) ),
+		  basic_csv_table_type<char>{}, pred );
+	}
+
+	template<typename T, std::size_t KeyIndex, typename Container = std::vector<T>,
+	         typename Constructor = daw::construct_a_t<Container>,
+	         typename Appender = text_table_details::basic_appender<Container>,
+	         typename Predicate>
+	[[maybe_unused, nodiscard]] constexpr Container
+	parse_csv_table_if( std::basic_string_view<wchar_t> rng, Predicate &&pred ) {
+		return parse_csv_table_if_impl<T, KeyIndex, Container, Constructor,
+		                               Appender>(
+		  daw::basic_string_view<wchar_t>( rng.data( ), rng.size( ) ),
+		  basic_csv_table_type<wchar_t>{}, pred );
+	}
+
+	/***
+	 * Parse the rows whose key cell satisfies pred, using an explicit table
+	 * type
+	 */
+	template<typename T, std::size_t KeyIndex, typename Container = std::vector<T>,
+	         typename Constructor = daw::construct_a_t<Container>,
+	         typename Appender = text_table_details::basic_appender<Container>,
+	         typename TableType, typename Predicate,
+	         std::enable_if_t<text_table_details::is_a_table_type_v<TableType>,
+	                          std::nullptr_t> = nullptr>
+	[[maybe_unused, nodiscard]] constexpr Container
+	parse_csv_table_if( std::basic_string_view<typename TableType::CharT> rng,
+	                    TableType const &table, Predicate &&pred ) {
+		return parse_csv_table_if_impl<T, KeyIndex, Container, Constructor,
+		                               Appender>(
+		  daw::basic_string_view<typename TableType::CharT>( rng.data( ),
+		                                                     rng.size( ) ),
+		  table, pred );
+	}
+
+	namespace text_table_details {
+		/***
+		 * Only newlines before the returned position start a new row.  A
+		 * newline must be followed by more data and, if the table requires it,
+		 * by a delimiter somewhere after it
+		 * @pre rng is not empty
+		 */
+		template<typename TableType>
+		[[nodiscard]] constexpr std::size_t
+		row_count_limit( daw::basic_string_view<typename TableType::CharT> rng,
+		                 TableType const &table ) {
+			if constexpr( TableType::ensure_delimiter_in_row ) {
+				auto pos = rng.size( );
+				while( pos > 0 ) {
+					--pos;
+					if( rng[pos] == table.delimiter_char ) {
+						return pos;
+					}
+				}
+				return 0;
+			} else {
+				return rng.size( ) - 1U;
+			}
+		}
+	} // namespace text_table_details
+
+	template<typename TableType>
+	[[maybe_unused, nodiscard]] constexpr std::size_t
+	table_row_count_impl( daw::basic_string_view<typename TableType::CharT> rng,
+	                      TableType const &table = TableType{} ) {
+		if constexpr( not TableType::allow_escaped ) {
+			if( not text_table_details::is_constant_evaluated( ) and
+			    not table.has_comment_rows( ) ) {
+				if( rng.empty( ) ) {
+					return 0;
+				}
+				auto const limit = text_table_details::row_count_limit( rng, table );
+				return 1U + text_table_details::structural::count_row_ends(
+				              rng.data( ), rng.data( ) + limit, table.quote_char,
+				              TableType::newline_char )
+				              .unquoted_start;
+			}
+		}
+		auto state = TableState<TableType>( rng, table );
 		std::size_t result = 0;
 		while( not state.at_eof( ) ) {
 			++result;
@@ -174,4 +481,25 @@ namespace daw::text_data {
 		return table_row_count_impl<TableType>(
 		  daw::basic_string_view<wchar_t>( rng.data( ), rng.size( ) ) );
 	}
+
+	template<typename Dialect,
+	         std::enable_if_t<text_table_details::is_dialect_v<Dialect>,
+	                          std::nullptr_t> = nullptr>
+	[[maybe_unused, nodiscard]] constexpr std::size_t
+	table_row_count( std::basic_string_view<char> rng, Dialect const &dialect ) {
+		return table_row_count_impl(
+		  daw::basic_string_view<char>( rng.data( ), rng.size( ) ),
+		  basic_dialect_table_type<char, Dialect>( dialect ) );
+	}
+
+	template<typename Dialect,
+	         std::enable_if_t<text_table_details::is_dialect_v<Dialect>,
+	                          std::nullptr_t> = nullptr>
+	[[maybe_unused, nodiscard]] constexpr std::size_t
+	table_row_count( std::basic_string_view<wchar_t> rng,
+	                 Dialect const &dialect ) {
+		return table_row_count_impl(
+		  daw::basic_string_view<wchar_t>( rng.data( ), rng.size( ) ),
+		  basic_dialect_table_type<wchar_t, Dialect>( dialect ) );
+	}
 } // namespace daw::text_data
@@ -0,0 +1,298 @@
+// The MIT License (MIT)
+//
+// Copyright (c) Darrell Wright
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and / or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include "daw_text_table_iterator.h"
+#include "daw_text_table_link.h"
+#include "impl/daw_csv_table.h"
+#include "impl/daw_text_table_assert.h"
+#include "impl/daw_text_table_link_common.h"
+#include "impl/daw_text_table_link_table_state.h"
+
+#include <daw/daw_string_view.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#if defined( __unix__ ) or defined( __APPLE__ )
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define DAW_TEXT_TABLE_USE_MMAP
+#else
+#include <daw/daw_memory_mapped_file.h>
+#include <memory>
+#endif
+
+namespace daw::text_data {
+	namespace text_table_details {
+		/***
+		 * A read only mapping of a whole file.  Paging advice is a no-op where
+		 * madvise is not available
+		 */
+		class mapped_file {
+#if defined( DAW_TEXT_TABLE_USE_MMAP )
+			char const *m_data = nullptr;
+			std::size_t m_size = 0;
+
+			static std::size_t page_size( ) {
+				static std::size_t const result =
+				  static_cast<std::size_t>( ::sysconf( _SC_PAGESIZE ) );
+				return result;
+			}
+
+			void advise( std::size_t first, std::size_t last, int advice ) const {
+				// madvise requires a page aligned start
+				first -= first % page_size( );
+				if( last > m_size ) {
+					last = m_size;
+				}
+				if( first < last ) {
+					(void)::madvise( const_cast<char *>( m_data ) + first, last - first,
+					                 advice );
+				}
+			}
+
+		public:
+			explicit mapped_file( std::string const &path ) {
+				int const fd = ::open( path.c_str( ), O_RDONLY );
+				daw_text_table_assert( fd >= 0, "Unable to open table file" );
+				struct ::stat st {};
+				if( ::fstat( fd, &st ) != 0 ) {
+					::close( fd );
+					daw_text_table_error( "Unable to read table file size" );
+				}
+				m_size = static_cast<std::size_t>( st.st_size );
+				if( m_size > 0 ) {
+					void *ptr = ::mmap( nullptr, m_size, PROT_READ, MAP_PRIVATE, fd, 0 );
+					::close( fd );
+					daw_text_table_assert( ptr != MAP_FAILED, "Unable to map table file" );
+					m_data = static_cast<char const *>( ptr );
+				} else {
+					::close( fd );
+				}
+			}
+
+			mapped_file( mapped_file const & ) = delete;
+			mapped_file &operator=( mapped_file const & ) = delete;
+
+			mapped_file( mapped_file &&other ) noexcept
+			  : m_data( std::exchange( other.m_data, nullptr ) )
+			  , m_size( std::exchange( other.m_size, 0U ) ) {}
+
+			mapped_file &operator=( mapped_file &&rhs ) noexcept {
+				if( this != &rhs ) {
+					reset( );
+					m_data = std::exchange( rhs.m_data, nullptr );
+					m_size = std::exchange( rhs.m_size, 0U );
+				}
+				return *this;
+			}
+
+			~mapped_file( ) {
+				reset( );
+			}
+
+			void reset( ) {
+				if( m_data != nullptr ) {
+					::munmap( const_cast<char *>( m_data ), m_size );
+					m_data = nullptr;
+					m_size = 0;
+				}
+			}
+
+			[[nodiscard]] char const *data( ) const {
+				return m_data;
+			}
+
+			[[nodiscard]] std::size_t size( ) const {
+				return m_size;
+			}
+
+			void advise_sequential( ) const {
+				advise( 0, m_size, MADV_SEQUENTIAL );
+			}
+
+			void advise_will_need( std::size_t first, std::size_t last ) const {
+				advise( first, last, MADV_WILLNEED );
+			}
+
+			/***
+			 * Drop the pages in [first, last) from memory.  They are read back from
+			 * the file if accessed again
+			 */
+			void advise_dont_need( std::size_t first, std::size_t last ) const {
+				// Only whole pages before last can be dropped
+				last -= last % page_size( );
+				advise( first, last, MADV_DONTNEED );
+			}
+#else
+			std::unique_ptr<daw::filesystem::memory_mapped_file_t<char>> m_file;
+
+		public:
+			explicit mapped_file( std::string const &path )
+			  : m_file( std::make_unique<daw::filesystem::memory_mapped_file_t<char>>(
+			      path ) ) {}
+
+			[[nodiscard]] char const *data( ) const {
+				return &*m_file->begin( );
+			}
+
+			[[nodiscard]] std::size_t size( ) const {
+				return m_file->size( );
+			}
+
+			void advise_sequential( ) const {}
+			void advise_will_need( std::size_t, std::size_t ) const {}
+			void advise_dont_need( std::size_t, std::size_t ) const {}
+#endif
+		};
+
+		/***
+		 * Keeps the pages in front of a parse cursor requested and, optionally,
+		 * releases the pages behind it so that the resident size stays near two
+		 * windows regardless of the file size
+		 */
+		class mapped_read_ahead {
+			mapped_file const *m_file;
+			std::size_t m_window;
+			bool m_release_consumed;
+			std::size_t m_requested_to = 0;
+			std::size_t m_released_to = 0;
+
+		public:
+			mapped_read_ahead( mapped_file const &file, std::size_t window,
+			                   bool release_consumed )
+			  : m_file( &file )
+			  , m_window( window )
+			  , m_release_consumed( release_consumed ) {
+				update( 0 );
+			}
+
+			void update( std::size_t cursor ) {
+				if( cursor + m_window / 2U >= m_requested_to and
+				    m_requested_to < m_file->size( ) ) {
+					auto const first = std::max( cursor, m_requested_to );
+					m_requested_to = first + m_window;
+					m_file->advise_will_need( first, m_requested_to );
+				}
+				if( m_release_consumed and cursor >= m_released_to + m_window ) {
+					m_file->advise_dont_need( m_released_to, cursor );
+					m_released_to = cursor;
+				}
+			}
+		};
+	} // namespace text_table_details
+
+	/***
+	 * A csv table read directly from a memory mapped file
+	 * @tparam T type of row with a text_data_contract
+	 */
+	template<typename T, typename TableType = basic_csv_table_type<char>>
+	class mapped_csv_table {
+		static_assert( std::is_same_v<typename TableType::CharT, char>,
+		               "Mapped tables are byte oriented" );
+
+		using parser_t = text_table_details::text_table_data_contract_trait_t<T>;
+
+		text_table_details::mapped_file m_file;
+		std::size_t m_window;
+		TableType m_table;
+
+	public:
+		using iterator = basic_text_table_iterator<T, TableType>;
+		static constexpr std::size_t default_window = 64U * 1024U * 1024U;
+
+		/***
+		 * @param path file to map
+		 * @param window number of bytes to request ahead of the parse cursor and
+		 * the granularity that consumed pages are released at
+		 */
+		explicit mapped_csv_table( std::string const &path,
+		                           std::size_t window = default_window,
+		                           TableType const &table = TableType{} )
+		  : m_file( path )
+		  , m_window( window )
+		  , m_table( table ) {
+			m_file.advise_sequential( );
+		}
+
+		[[nodiscard]] std::string_view data( ) const {
+			return std::string_view( m_file.data( ), m_file.size( ) );
+		}
+
+		[[nodiscard]] iterator begin( ) const {
+			return iterator( data( ), m_table );
+		}
+
+		[[nodiscard]] iterator end( ) const {
+			return iterator( );
+		}
+
+		/***
+		 * Call on_row with each row of the table in order.  The pages that have
+		 * been parsed are released as the parse advances, any references into
+		 * the table remain valid and page the data back in when accessed
+		 */
+		template<typename OnRow>
+		void for_each( OnRow &&on_row ) const {
+			static_assert( text_table_details::check_arena_container<parser_t>( ) );
+			for_each_row( on_row );
+		}
+
+		template<typename Container = std::vector<T>,
+		         typename Constructor = daw::construct_a_t<Container>,
+		         typename Appender = text_table_details::basic_appender<Container>>
+		[[nodiscard]] Container parse( ) const {
+			static_assert(
+			  text_table_details::check_arena_container<parser_t, Container>( ) );
+			auto result = Constructor{}( );
+			auto appender = Appender( result );
+			for_each_row( [&]( auto &&row ) {
+				appender( std::forward<decltype( row )>( row ) );
+			} );
+			return result;
+		}
+
+	private:
+		template<typename OnRow>
+		void for_each_row( OnRow &&on_row ) const {
+			auto const table = data( );
+			auto state = TableState<TableType>(
+			  daw::basic_string_view<char>( table.data( ), table.size( ) ), m_table );
+			auto loc_info = parser_t::template location_info<TableType>( state );
+			auto read_ahead =
+			  text_table_details::mapped_read_ahead( m_file, m_window, true );
+			while( not state.at_eof( ) ) {
+				read_ahead.update( static_cast<std::size_t>(
+				  state.remaining( ).data( ) - table.data( ) ) );
+				on_row( parser_t::template parse_row<T>( state, loc_info ) );
+			}
+		}
+	};
+} // namespace daw::text_data
@@ -0,0 +1,288 @@
+// The MIT License (MIT)
+//
+// Copyright (c) Darrell Wright
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and / or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include "daw_text_table_link.h"
+#include "impl/daw_csv_table.h"
+#include "impl/daw_text_table_link_common.h"
+#include "impl/daw_text_table_link_table_state.h"
+#include "impl/daw_text_table_structural.h"
+
+#include <daw/daw_string_view.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <future>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace daw::text_data {
+	namespace text_table_details {
+		/***
+		 * Chunks smaller than this are not worth a thread
+		 */
+		inline constexpr std::size_t min_parallel_chunk_size = 1024U * 1024U;
+
+		[[nodiscard]] inline std::size_t default_thread_count( ) {
+			return std::max( std::size_t{1},
+			                 static_cast<std::size_t>(
+			                   std::thread::hardware_concurrency( ) ) );
+		}
+
+		/***
+		 * Split rng into at most chunk_count ranges that each start at the
+		 * beginning of a row.  The quoted state at each tentative split point is
+		 * exact, it comes from the parity of the quote count of the preceding
+		 * chunks which are counted in parallel.  This keeps newlines inside of
+		 * quoted cells from being used as a split point.  Quotes in comment rows
+		 * do not open a quoted cell, so a table with comment rows is not split
+		 * @pre rng starts at the beginning of a row
+		 */
+		template<typename TableType,
+		         typename CharT = typename TableType::CharT>
+		[[nodiscard]] std::vector<daw::basic_string_view<CharT>>
+		split_rows( daw::basic_string_view<CharT> rng, std::size_t chunk_count,
+		            TableType const &table ) {
+			static_assert( not TableType::allow_escaped,
+			               "Escaped quotes make split points ambiguous" );
+			auto const sz = rng.size( );
+			auto const first = rng.data( );
+			if( table.has_comment_rows( ) ) {
+				return {rng};
+			}
+			chunk_count = std::clamp( sz / min_parallel_chunk_size, std::size_t{1},
+			                          std::max( chunk_count, std::size_t{1} ) );
+
+			auto split_point = [&]( std::size_t n ) {
+				return ( sz / chunk_count ) * n;
+			};
+
+			std::vector<std::future<bool>> odd_quote_counts{};
+			odd_quote_counts.reserve( chunk_count - 1U );
+			for( std::size_t n = 1; n < chunk_count; ++n ) {
+				odd_quote_counts.push_back( std::async(
+				  std::launch::async,
+				  structural::has_odd_quote_count<CharT>, first + split_point( n - 1 ),
+				  first + split_point( n ), table.quote_char ) );
+			}
+
+			auto result = std::vector<daw::basic_string_view<CharT>>( );
+			result.reserve( chunk_count );
+			std::size_t start = 0;
+			bool in_quote = false;
+			for( std::size_t n = 1; n < chunk_count; ++n ) {
+				in_quote = in_quote != odd_quote_counts[n - 1].get( );
+				auto const split = split_point( n );
+				if( split < start ) {
+					// The previous row spanned this split point
+					continue;
+				}
+				auto const row_end =
+				  split + structural::find_row_end( first + split, first + sz,
+				                                    table.quote_char,
+				                                    TableType::newline_char, in_quote );
+				if( row_end >= sz ) {
+					break;
+				}
+				result.emplace_back( first + start, row_end + 1U - start );
+				start = row_end + 1U;
+			}
+			result.emplace_back( first + start, sz - start );
+			return result;
+		}
+
+		/***
+		 * Parse each chunk of data rows into its own Container and append them
+		 * in order
+		 */
+		template<typename T, typename Container, typename Constructor,
+		         typename Appender, typename TableType, typename LocationInfo>
+		[[nodiscard]] Container parse_chunks_parallel(
+		  std::vector<daw::basic_string_view<typename TableType::CharT>> const
+		    &chunks,
+		  LocationInfo const &loc_info, TableType const &table ) {
+			using CharT = typename TableType::CharT;
+			using parser_t = text_table_data_contract_trait_t<T>;
+			static_assert( check_arena_container<parser_t, Container>( ) );
+
+			auto parse_chunk = [&]( daw::basic_string_view<CharT> chunk ) {
+				auto chunk_state = TableState<TableType>( chunk, table );
+				auto chunk_loc_info = loc_info;
+				auto part = Constructor{}( );
+				auto appender = Appender( part );
+				while( not chunk_state.at_eof( ) ) {
+					appender(
+					  parser_t::template parse_row<T>( chunk_state, chunk_loc_info ) );
+				}
+				return part;
+			};
+
+			auto parts = std::vector<std::future<Container>>( );
+			parts.reserve( chunks.size( ) - 1U );
+			for( std::size_t n = 1; n < chunks.size( ); ++n ) {
+				parts.push_back(
+				  std::async( std::launch::async, parse_chunk, chunks[n] ) );
+			}
+			auto result = parse_chunk( chunks.front( ) );
+			if constexpr( has_splice_v<Container> ) {
+				for( auto &part_future : parts ) {
+					result.splice( part_future.get( ) );
+				}
+			} else {
+				auto appender = Appender( result );
+				for( auto &part_future : parts ) {
+					auto part = part_future.get( );
+					for( auto &value : part ) {
+						appender( std::move( value ) );
+					}
+				}
+			}
+			return result;
+		}
+	} // namespace text_table_details
+
+	template<typename T, typename Container, typename Constructor,
+	         typename Appender, typename TableType>
+	[[maybe_unused, nodiscard]] Container parse_csv_table_parallel_impl(
+	  daw::basic_string_view<typename TableType::CharT> rng,
+	  std::size_t thread_count, TableType const &table ) {
+		using parser_t = text_table_details::text_table_data_contract_trait_t<T>;
+
+		auto state = TableState<TableType>( rng, table );
+		auto const loc_info = parser_t::template location_info<TableType>( state );
+		return text_table_details::parse_chunks_parallel<T, Container, Constructor,
+		                                                 Appender>(
+		  text_table_details::split_rows( state.remaining( ), thread_count, table ),
+		  loc_info, table );
+	}
+
+	/***
+	 * Parse a csv table using multiple threads.  The rows are split into
+	 * chunks at row boundaries, each chunk is parsed into its own Container and
+	 * the results are appended in order
+	 * @tparam T type of row with a text_data_contract
+	 * @param rng table data
+	 * @param thread_count maximum number of threads to use
+	 * @return Container of T in the same order as the table rows
+	 */
+	template<typename T, typename Container = std::vector<T>,
+	         typename Constructor = daw::construct_a_t<Container>,
+	         typename Appender = text_table_details::basic_appender<Container>>
+	[[maybe_unused, nodiscard]] Container parse_csv_table_parallel(
+	  std::basic_string_view<char> rng,
+	  std::size_t thread_count = text_table_details::default_thread_count( ) ) {
+		return parse_csv_table_parallel_impl<T, Container, Constructor, Appender>(
+		  daw::basic_string_view<char>( rng.data( ), rng.size( ) ), thread_count,
+		  basic_csv_table_type<char>{} );
+	}
+
+	template<typename T, typename Container = std::vector<T>,
+	         typename Constructor = daw::construct_a_t<Container>,
+	         typename Appender = text_table_details::basic_appender<Container>>
+	[[maybe_unused, nodiscard]] Container parse_csv_table_parallel(
+	  std::basic_string_view<wchar_t> rng,
+	  std::size_t thread_count = text_table_details::default_thread_count( ) ) {
+		return parse_csv_table_parallel_impl<T, Container, Constructor, Appender>(
+		  daw::basic_string_view<wchar_t>( rng.data( ), rng.size( ) ),
+		  thread_count, basic_csv_table_type<wchar_t>{} );
+	}
+
+	/***
+	 * Parse a table in a dialect other than comma separated values using
+	 * multiple threads
+	 * @param dialect a text_dialect such as tsv_dialect{} or a runtime_dialect
+	 */
+	template<typename T, typename Container = std::vector<T>,
+	         typename Constructor = daw::construct_a_t<Container>,
+	         typename Appender = text_table_details::basic_appender<Container>,
+	         typename Dialect,
+	         std::enable_if_t<text_table_details::is_dialect_v<Dialect>,
+	                          std::nullptr_t> = nullptr>
+	[[maybe_unused, nodiscard]] Container parse_csv_table_parallel(
+	  std::basic_string_view<char> rng, Dialect const &dialect,
+	  std::size_t thread_count = text_table_details::default_thread_count( ) ) {
+		return parse_csv_table_parallel_impl<T, Container, Constructor, Appender>(
+		  daw::basic_string_view<char>( rng.data( ), rng.size( ) ), thread_count,
+		  basic_dialect_table_type<char, Dialect>( dialect ) );
+	}
+
+	template<typename TableType>
+	[[maybe_unused, nodiscard]] std::size_t table_row_count_parallel_impl(
+	  daw::basic_string_view<typename TableType::CharT> rng,
+	  std::size_t thread_count, TableType const &table = TableType{} ) {
+		using CharT = typename TableType::CharT;
+		static_assert( not TableType::allow_escaped,
+		               "Escaped quotes make split points ambiguous" );
+		if( rng.empty( ) or table.has_comment_rows( ) ) {
+			return table_row_count_impl( rng, table );
+		}
+		auto const limit = text_table_details::row_count_limit( rng, table );
+		auto const chunk_count = std::clamp(
+		  limit / text_table_details::min_parallel_chunk_size, std::size_t{1},
+		  std::max( thread_count, std::size_t{1} ) );
+		auto const chunk_size = limit / chunk_count;
+
+		auto counts =
+		  std::vector<std::future<text_table_details::structural::row_end_counts>>( );
+		counts.reserve( chunk_count );
+		for( std::size_t n = 0; n < chunk_count; ++n ) {
+			auto const first = rng.data( ) + chunk_size * n;
+			auto const last =
+			  n + 1U == chunk_count ? rng.data( ) + limit : first + chunk_size;
+			counts.push_back( std::async(
+			  std::launch::async,
+			  text_table_details::structural::count_row_ends<CharT>, first, last,
+			  table.quote_char, TableType::newline_char ) );
+		}
+		std::size_t result = 1;
+		bool in_quote = false;
+		for( auto &count_future : counts ) {
+			auto const count = count_future.get( );
+			result += in_quote ? count.quoted_start : count.unquoted_start;
+			in_quote = in_quote != count.odd_quote_count;
+		}
+		return result;
+	}
+
+	/***
+	 * Count the rows of a table, including any header rows, using multiple
+	 * threads.  The result is the same as table_row_count
+	 */
+	template<typename TableType = basic_csv_table_type<char>>
+	[[maybe_unused, nodiscard]] std::size_t table_row_count_parallel(
+	  std::basic_string_view<char> rng,
+	  std::size_t thread_count = text_table_details::default_thread_count( ) ) {
+		return table_row_count_parallel_impl<TableType>(
+		  daw::basic_string_view<char>( rng.data( ), rng.size( ) ), thread_count );
+	}
+
+	template<typename TableType = basic_csv_table_type<wchar_t>>
+	[[maybe_unused, nodiscard]] std::size_t table_row_count_parallel(
+	  std::basic_string_view<wchar_t> rng,
+	  std::size_t thread_count = text_table_details::default_thread_count( ) ) {
+		return table_row_count_parallel_impl<TableType>(
+		  daw::basic_string_view<wchar_t>( rng.data( ), rng.size( ) ),
+		  thread_count );
+	}
+} // namespace daw::text_data
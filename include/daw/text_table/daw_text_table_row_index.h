@@ -0,0 +1,410 @@
+// The MIT License (MIT)
+//
+// Copyright (c) Darrell Wright
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and / or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include "daw_text_table_link.h"
+#include "daw_text_table_parallel.h"
+#include "impl/daw_csv_table.h"
+#include "impl/daw_text_table_assert.h"
+#include "impl/daw_text_table_link_common.h"
+#include "impl/daw_text_table_link_table_state.h"
+
+#include <daw/daw_string_view.h>
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+namespace daw::text_data {
+	namespace text_table_details {
+		/***
+		 * Every Kth data row is recorded.  With the default a row is at most
+		 * 1023 rows from an indexed one and a 150M row table has an index of
+		 * about 1MiB
+		 */
+		inline constexpr std::size_t default_row_index_stride = 1024U;
+
+		/***
+		 * The number of elements at each end of the table that are hashed to
+		 * detect a changed table
+		 */
+		inline constexpr std::size_t row_index_hash_size = 64U * 1024U;
+
+		inline constexpr std::uint64_t row_index_magic = 0x3149'5254'5457'4144ULL;
+
+		template<typename CharT>
+		[[nodiscard]] constexpr std::uint64_t
+		fnv1a_hash( std::uint64_t hash, CharT const *first, CharT const *last ) {
+			for( ; first != last; ++first ) {
+				hash ^= static_cast<std::uint64_t>(
+				  static_cast<std::make_unsigned_t<CharT>>( *first ) );
+				hash *= 0x0000'0100'0000'01B3ULL;
+			}
+			return hash;
+		}
+	} // namespace text_table_details
+
+	/***
+	 * Identifies the table a row_index was built from.  An index whose key
+	 * does not match the table is rebuilt
+	 */
+	struct row_index_key {
+		std::uint64_t size = 0;
+		// The modification time of the table file, 0 for tables in memory
+		std::int64_t mtime = 0;
+		// A hash of the start and the end of the table
+		std::uint64_t hash = 0;
+
+		constexpr bool operator==( row_index_key const &rhs ) const {
+			return size == rhs.size and mtime == rhs.mtime and hash == rhs.hash;
+		}
+
+		constexpr bool operator!=( row_index_key const &rhs ) const {
+			return not operator==( rhs );
+		}
+	};
+
+	template<typename CharT>
+	[[nodiscard]] row_index_key
+	make_row_index_key( std::basic_string_view<CharT> data,
+	                    std::int64_t mtime = 0 ) {
+		using text_table_details::row_index_hash_size;
+		auto const first = data.data( );
+		auto const last = data.data( ) + data.size( );
+		auto const head = std::min( data.size( ), row_index_hash_size );
+		auto const tail =
+		  std::min( data.size( ) - head, row_index_hash_size );
+		auto hash = text_table_details::fnv1a_hash( 0xCBF2'9CE4'8422'2325ULL,
+		                                            first, first + head );
+		hash = text_table_details::fnv1a_hash( hash, last - tail, last );
+		return row_index_key{static_cast<std::uint64_t>( data.size( ) ), mtime,
+		                     hash};
+	}
+
+	/***
+	 * The modification time of a file, or 0 when it cannot be read
+	 */
+	[[nodiscard]] inline std::int64_t file_mtime( std::string const &path ) {
+		auto ec = std::error_code( );
+		auto const result = std::filesystem::last_write_time( path, ec );
+		if( ec ) {
+			return 0;
+		}
+		return static_cast<std::int64_t>( result.time_since_epoch( ).count( ) );
+	}
+
+	/***
+	 * The offsets of every Kth data row of a table.  The offsets are the start
+	 * of a row and so are never inside of a quoted cell, a row can be reached
+	 * by skipping at most K - 1 rows from the nearest indexed one
+	 */
+	class row_index {
+		std::size_t m_stride = text_table_details::default_row_index_stride;
+		std::size_t m_row_count = 0;
+		row_index_key m_key{};
+		// Offset of data row n * m_stride in elements from the start of the table
+		std::vector<std::uint64_t> m_offsets{};
+
+	public:
+		struct position {
+			std::size_t offset;
+			std::size_t row;
+		};
+
+		row_index( ) = default;
+		row_index( std::size_t stride, std::size_t row_count,
+		           row_index_key const &key, std::vector<std::uint64_t> offsets )
+		  : m_stride( stride )
+		  , m_row_count( row_count )
+		  , m_key( key )
+		  , m_offsets( std::move( offsets ) ) {
+			daw_text_table_assert( m_stride > 0, "Expected a non-zero stride" );
+		}
+
+		[[nodiscard]] std::size_t stride( ) const {
+			return m_stride;
+		}
+
+		/***
+		 * The number of data rows in the table
+		 */
+		[[nodiscard]] std::size_t row_count( ) const {
+			return m_row_count;
+		}
+
+		[[nodiscard]] row_index_key const &key( ) const {
+			return m_key;
+		}
+
+		[[nodiscard]] std::vector<std::uint64_t> const &offsets( ) const {
+			return m_offsets;
+		}
+
+		/***
+		 * The nearest indexed row at or before row.  The offset is the end of
+		 * the table when there are no data rows
+		 */
+		[[nodiscard]] position find( std::size_t row ) const {
+			if( m_offsets.empty( ) ) {
+				return position{static_cast<std::size_t>( m_key.size ), 0};
+			}
+			auto const idx = std::min( row / m_stride, m_offsets.size( ) - 1U );
+			return position{static_cast<std::size_t>( m_offsets[idx] ),
+			                idx * m_stride};
+		}
+
+		/***
+		 * Write the index to a sidecar file in the byte order of this machine
+		 * @return true if the whole index was written
+		 */
+		bool save( std::string const &path ) const {
+			auto out = std::ofstream( path, std::ios::binary | std::ios::trunc );
+			auto const header = std::array<std::uint64_t, 7>{
+			  text_table_details::row_index_magic,
+			  static_cast<std::uint64_t>( m_stride ),
+			  static_cast<std::uint64_t>( m_row_count ),
+			  m_key.size,
+			  static_cast<std::uint64_t>( m_key.mtime ),
+			  m_key.hash,
+			  static_cast<std::uint64_t>( m_offsets.size( ) )};
+			out.write( reinterpret_cast<char const *>( header.data( ) ),
+			           static_cast<std::streamsize>( sizeof( header ) ) );
+			out.write( reinterpret_cast<char const *>( m_offsets.data( ) ),
+			           static_cast<std::streamsize>( m_offsets.size( ) *
+			                                         sizeof( std::uint64_t ) ) );
+			return static_cast<bool>( out );
+		}
+
+		/***
+		 * Read an index from a sidecar file
+		 * @return the index, or nothing if the file is missing, damaged, has
+		 * offsets that are out of order or past the end of the table, or was
+		 * written for a table with a different key
+		 */
+		[[nodiscard]] static std::optional<row_index>
+		load( std::string const &path, row_index_key const &key ) {
+			auto in = std::ifstream( path, std::ios::binary );
+			auto header = std::array<std::uint64_t, 7>{};
+			if( not in.read( reinterpret_cast<char *>( header.data( ) ),
+			                 static_cast<std::streamsize>( sizeof( header ) ) ) ) {
+				return std::nullopt;
+			}
+			auto const file_key = row_index_key{
+			  header[3], static_cast<std::int64_t>( header[4] ), header[5]};
+			if( header[0] != text_table_details::row_index_magic or
+			    header[1] == 0 or file_key != key ) {
+				return std::nullopt;
+			}
+			// There is an offset for every stride'th row
+			auto const offset_count =
+			  header[2] / header[1] + ( header[2] % header[1] == 0 ? 0U : 1U );
+			if( header[2] > key.size or header[6] != offset_count ) {
+				return std::nullopt;
+			}
+			auto offsets =
+			  std::vector<std::uint64_t>( static_cast<std::size_t>( header[6] ) );
+			if( not in.read( reinterpret_cast<char *>( offsets.data( ) ),
+			                 static_cast<std::streamsize>(
+			                   offsets.size( ) * sizeof( std::uint64_t ) ) ) ) {
+				return std::nullopt;
+			}
+			// Each offset must be the start of a row inside of the table
+			for( std::size_t n = 0; n < offsets.size( ); ++n ) {
+				if( offsets[n] >= key.size or
+				    ( n > 0 and offsets[n] <= offsets[n - 1U] ) ) {
+					return std::nullopt;
+				}
+			}
+			return row_index( static_cast<std::size_t>( header[1] ),
+			                  static_cast<std::size_t>( header[2] ), file_key,
+			                  std::move( offsets ) );
+		}
+	};
+
+	template<typename TableType>
+	[[nodiscard]] row_index
+	build_row_index_impl( daw::basic_string_view<typename TableType::CharT> rng,
+	                      std::size_t stride, row_index_key const &key,
+	                      TableType const &table ) {
+		daw_text_table_assert( stride > 0, "Expected a non-zero stride" );
+		auto state = TableState<TableType>( rng, table );
+		state.row_move_to_header( );
+		state.row_move_to_data( );
+		auto offsets = std::vector<std::uint64_t>( );
+		std::size_t row = 0;
+		while( not state.at_eof( ) ) {
+			if( row % stride == 0 ) {
+				offsets.push_back( static_cast<std::uint64_t>(
+				  state.remaining( ).data( ) - rng.data( ) ) );
+			}
+			state.row_move_to_next( );
+			++row;
+		}
+		return row_index( stride, row, key, std::move( offsets ) );
+	}
+
+	/***
+	 * Record the offset of every stride'th data row of a table
+	 * @param mtime modification time of the table file, if any, that is part
+	 * of the key
+	 */
+	template<typename TableType = basic_csv_table_type<char>>
+	[[maybe_unused, nodiscard]] row_index build_row_index(
+	  std::basic_string_view<char> rng,
+	  std::size_t stride = text_table_details::default_row_index_stride,
+	  TableType const &table = TableType{}, std::int64_t mtime = 0 ) {
+		return build_row_index_impl(
+		  daw::basic_string_view<char>( rng.data( ), rng.size( ) ), stride,
+		  make_row_index_key( rng, mtime ), table );
+	}
+
+	template<typename TableType = basic_csv_table_type<wchar_t>>
+	[[maybe_unused, nodiscard]] row_index build_row_index(
+	  std::basic_string_view<wchar_t> rng,
+	  std::size_t stride = text_table_details::default_row_index_stride,
+	  TableType const &table = TableType{}, std::int64_t mtime = 0 ) {
+		return build_row_index_impl(
+		  daw::basic_string_view<wchar_t>( rng.data( ), rng.size( ) ), stride,
+		  make_row_index_key( rng, mtime ), table );
+	}
+
+	/***
+	 * Read the sidecar index of a table file, building and writing it when it
+	 * is missing or the table has changed size, modification time or content
+	 * @param table_path path of the table file, for its modification time
+	 * @param rng the contents of the table file, e.g. mapped_csv_table::data( )
+	 * @param index_path path of the sidecar file
+	 */
+	template<typename TableType = basic_csv_table_type<char>>
+	[[maybe_unused, nodiscard]] row_index load_or_build_row_index(
+	  std::string const &table_path, std::basic_string_view<char> rng,
+	  std::string const &index_path,
+	  std::size_t stride = text_table_details::default_row_index_stride,
+	  TableType const &table = TableType{} ) {
+		auto const key = make_row_index_key( rng, file_mtime( table_path ) );
+		if( auto index = row_index::load( index_path, key ) ) {
+			return std::move( *index );
+		}
+		auto result = build_row_index_impl(
+		  daw::basic_string_view<char>( rng.data( ), rng.size( ) ), stride, key,
+		  table );
+		// A sidecar that cannot be written only costs a rebuild next time
+		(void)result.save( index_path );
+		return result;
+	}
+
+	namespace text_table_details {
+		/***
+		 * Split the data rows of rng into at most chunk_count ranges at
+		 * indexed rows.  No searching for row ends is needed
+		 */
+		template<typename CharT>
+		[[nodiscard]] std::vector<daw::basic_string_view<CharT>>
+		split_rows( daw::basic_string_view<CharT> rng, row_index const &index,
+		            std::size_t chunk_count ) {
+			auto const &offsets = index.offsets( );
+			auto const first = rng.data( );
+			auto start = offsets.empty( ) ? rng.size( )
+			                              : static_cast<std::size_t>( offsets[0] );
+			auto const sz = rng.size( ) - start;
+			chunk_count = std::clamp( sz / min_parallel_chunk_size, std::size_t{1},
+			                          std::max( chunk_count, std::size_t{1} ) );
+
+			auto result = std::vector<daw::basic_string_view<CharT>>( );
+			result.reserve( chunk_count );
+			auto const data_start = start;
+			for( std::size_t n = 1; n < chunk_count; ++n ) {
+				auto const split = static_cast<std::uint64_t>(
+				  data_start + ( sz / chunk_count ) * n );
+				auto const pos =
+				  std::lower_bound( offsets.begin( ), offsets.end( ), split );
+				if( pos == offsets.end( ) ) {
+					break;
+				}
+				auto const row_start = static_cast<std::size_t>( *pos );
+				if( row_start <= start ) {
+					continue;
+				}
+				result.emplace_back( first + start, row_start - start );
+				start = row_start;
+			}
+			result.emplace_back( first + start, rng.size( ) - start );
+			return result;
+		}
+	} // namespace text_table_details
+
+	template<typename T, typename Container, typename Constructor,
+	         typename Appender, typename TableType>
+	[[maybe_unused, nodiscard]] Container parse_csv_table_parallel_impl(
+	  daw::basic_string_view<typename TableType::CharT> rng,
+	  row_index const &index, std::size_t thread_count,
+	  TableType const &table ) {
+		using parser_t = text_table_details::text_table_data_contract_trait_t<T>;
+		daw_text_table_assert( index.key( ).size == rng.size( ),
+		                       "The row index is for a different table" );
+
+		auto state = TableState<TableType>( rng, table );
+		auto const loc_info = parser_t::template location_info<TableType>( state );
+		return text_table_details::parse_chunks_parallel<T, Container, Constructor,
+		                                                 Appender>(
+		  text_table_details::split_rows( rng, index, thread_count ), loc_info,
+		  table );
+	}
+
+	/***
+	 * Parse a csv table using multiple threads, splitting it at the rows of
+	 * index.  Unlike splitting by size this needs no search for the row ends
+	 * or count of the quotes before each split point
+	 * @param index a row_index built from rng
+	 */
+	template<typename T, typename Container = std::vector<T>,
+	         typename Constructor = daw::construct_a_t<Container>,
+	         typename Appender = text_table_details::basic_appender<Container>>
+	[[maybe_unused, nodiscard]] Container parse_csv_table_parallel(
+	  std::basic_string_view<char> rng, row_index const &index,
+	  std::size_t thread_count = text_table_details::default_thread_count( ) ) {
+		return parse_csv_table_parallel_impl<T, Container, Constructor, Appender>(
+		  daw::basic_string_view<char>( rng.data( ), rng.size( ) ), index,
+		  thread_count, basic_csv_table_type<char>{} );
+	}
+
+	template<typename T, typename Container = std::vector<T>,
+	         typename Constructor = daw::construct_a_t<Container>,
+	         typename Appender = text_table_details::basic_appender<Container>>
+	[[maybe_unused, nodiscard]] Container parse_csv_table_parallel(
+	  std::basic_string_view<wchar_t> rng, row_index const &index,
+	  std::size_t thread_count = text_table_details::default_thread_count( ) ) {
+		return parse_csv_table_parallel_impl<T, Container, Constructor, Appender>(
+		  daw::basic_string_view<wchar_t>( rng.data( ), rng.size( ) ), index,
+		  thread_count, basic_csv_table_type<wchar_t>{} );
+	}
+} // namespace daw::text_data
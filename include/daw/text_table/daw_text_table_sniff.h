@@ -0,0 +1,411 @@
+// The MIT License (MIT)
+//
+// Copyright (c) Darrell Wright
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and / or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include "impl/daw_csv_table.h"
+#include "impl/daw_text_table_dialect.h"
+#include "impl/daw_text_table_link_parser_helpers.h"
+#include "impl/daw_text_table_structural.h"
+
+#include <daw/daw_string_view.h>
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace daw::text_data {
+	enum class line_ending : std::uint8_t { Lf, CrLf };
+
+	/***
+	 * The narrowest parser that accepts every non-empty cell of a column.  A
+	 * later value accepts everything an earlier one does
+	 */
+	enum class sniffed_type : std::uint8_t { Unsigned, Signed, Real, String };
+
+	/***
+	 * The layout of a table as inferred by sniff_table.  dialect can be passed
+	 * to parse_csv_table to parse a table with a header.  Whether there is a
+	 * header is part of the table type, as columns found by name need one, so
+	 * when has_header is false parse with
+	 * basic_headerless_dialect_table_type<char, runtime_dialect>( dialect )
+	 * and a contract of text_column_at columns
+	 */
+	struct table_descriptor {
+		runtime_dialect dialect{};
+		bool has_header = true;
+		line_ending line_endings = line_ending::Lf;
+		std::vector<sniffed_type> column_types{};
+	};
+
+	namespace text_table_details {
+		inline constexpr std::size_t default_sniff_size = 16U * 1024U;
+		inline constexpr std::array<char, 4> sniff_delimiters = {',', '\t', '|',
+		                                                         ';'};
+
+		struct sniffed_characters {
+			char quote = '"';
+			bool crlf = false;
+		};
+
+		[[nodiscard]] constexpr bool is_sniff_separator( char c ) {
+			return c == '\n' or std::find( sniff_delimiters.begin( ),
+			                               sniff_delimiters.end( ),
+			                               c ) != sniff_delimiters.end( );
+		}
+
+		/***
+		 * Whether every cell that starts with quote is closed right before a
+		 * delimiter candidate, a line ending or the end of the sample.  A cell
+		 * that is still open at the end of the sample may have been cut
+		 */
+		[[nodiscard]] inline bool quoted_cells_close( std::string_view sample,
+		                                              char quote ) {
+			bool is_cell_start = true;
+			for( std::size_t n = 0; n < sample.size( ); ++n ) {
+				if( not is_cell_start or sample[n] != quote ) {
+					is_cell_start = is_sniff_separator( sample[n] );
+					continue;
+				}
+				for( ++n; n < sample.size( ); ++n ) {
+					if( sample[n] == quote ) {
+						if( n + 1U < sample.size( ) and sample[n + 1U] == quote ) {
+							++n;
+							continue;
+						}
+						break;
+					}
+				}
+				if( n + 1U < sample.size( ) and sample[n + 1U] != '\r' and
+				    not is_sniff_separator( sample[n + 1U] ) ) {
+					return false;
+				}
+				is_cell_start = false;
+			}
+			return true;
+		}
+
+		/***
+		 * The quote character is the one that starts the most cells, as long as
+		 * those cells are closed, and the line ending is \r\n when most rows end
+		 * with it
+		 */
+		[[nodiscard]] inline sniffed_characters
+		sniff_characters( std::string_view sample ) {
+			std::size_t double_quotes = 0;
+			std::size_t single_quotes = 0;
+			std::size_t crlf_rows = 0;
+			std::size_t rows = 0;
+			// The sample starts with a cell
+			std::uint64_t start_carry = 1;
+			std::uint64_t cr_carry = 0;
+			structural::for_each_block(
+			  sample.data( ), sample.data( ) + sample.size( ),
+			  [&]( structural::simd_block const &blk, std::size_t len, std::size_t ) {
+				  auto const valid = structural::valid_mask( len );
+				  auto const newlines = blk.eq( '\n' ) & valid;
+				  auto separators = newlines;
+				  for( auto const delimiter : sniff_delimiters ) {
+					  separators |= blk.eq( delimiter );
+				  }
+				  separators &= valid;
+				  auto const starts = ( ( separators << 1U ) | start_carry ) & valid;
+				  double_quotes += structural::popcount( blk.eq( '"' ) & starts );
+				  single_quotes += structural::popcount( blk.eq( '\'' ) & starts );
+				  auto const carriage_returns = blk.eq( '\r' ) & valid;
+				  crlf_rows += structural::popcount(
+				    ( ( carriage_returns << 1U ) | cr_carry ) & newlines );
+				  rows += structural::popcount( newlines );
+				  start_carry = separators >> 63U;
+				  cr_carry = carriage_returns >> 63U;
+				  return false;
+			  } );
+			auto result = sniffed_characters{};
+			// Cells like 's-Hertogenbosch start with a ' that is not a quote
+			if( single_quotes > double_quotes and
+			    quoted_cells_close( sample, '\'' ) ) {
+				result.quote = '\'';
+			}
+			result.crlf = rows > 0 and crlf_rows * 2U > rows;
+			return result;
+		}
+
+		/***
+		 * The delimiter is the candidate that occurs the same, non-zero, number
+		 * of times in the most rows.  Ties go to the larger count
+		 */
+		[[nodiscard]] inline char sniff_delimiter( std::string_view sample,
+		                                           char quote ) {
+			using counts_t = std::array<std::size_t, sniff_delimiters.size( )>;
+			auto rows = std::vector<counts_t>( );
+			structural::count_per_row( sample.data( ), sample.data( ) + sample.size( ),
+			                           quote, '\n', sniff_delimiters,
+			                           [&]( counts_t const &counts ) {
+				                           rows.push_back( counts );
+				                           return false;
+			                           } );
+			char result = ',';
+			std::size_t best_rows = 0;
+			std::size_t best_count = 0;
+			auto column = std::vector<std::size_t>( rows.size( ) );
+			for( std::size_t n = 0; n < sniff_delimiters.size( ); ++n ) {
+				for( std::size_t r = 0; r < rows.size( ); ++r ) {
+					column[r] = rows[r][n];
+				}
+				std::sort( column.begin( ), column.end( ) );
+				for( auto first = column.begin( ); first != column.end( ); ) {
+					auto const last = std::upper_bound( first, column.end( ), *first );
+					auto const row_count = static_cast<std::size_t>( last - first );
+					if( *first > 0 and
+					    ( row_count > best_rows or
+					      ( row_count == best_rows and *first > best_count ) ) ) {
+						result = sniff_delimiters[n];
+						best_rows = row_count;
+						best_count = *first;
+					}
+					first = last;
+				}
+			}
+			return result;
+		}
+
+		/***
+		 * Split a row, without its newline, into its cells.  Quoted cells are
+		 * returned without their quotes
+		 * @return false when the row is malformed, e.g. a quoted cell is not
+		 * closed or is followed by more than a delimiter
+		 */
+		[[nodiscard]] inline bool
+		split_sniffed_row( std::string_view row, char delimiter, char quote,
+		                   std::vector<std::string_view> &cells ) {
+			cells.clear( );
+			if( not row.empty( ) and row.back( ) == '\r' ) {
+				row.remove_suffix( 1 );
+			}
+			std::size_t pos = 0;
+			while( pos < row.size( ) ) {
+				if( row[pos] != quote ) {
+					auto const cell_end =
+					  std::min( row.find( delimiter, pos ), row.size( ) );
+					cells.push_back( row.substr( pos, cell_end - pos ) );
+					pos = cell_end + 1U;
+					continue;
+				}
+				auto cell_end = pos + 1U;
+				for( ; cell_end < row.size( ); ++cell_end ) {
+					if( row[cell_end] == quote ) {
+						if( cell_end + 1U < row.size( ) and row[cell_end + 1U] == quote ) {
+							++cell_end;
+							continue;
+						}
+						break;
+					}
+				}
+				if( cell_end >= row.size( ) or
+				    ( cell_end + 1U < row.size( ) and
+				      row[cell_end + 1U] != delimiter ) ) {
+					return false;
+				}
+				cells.push_back( row.substr( pos + 1U, cell_end - pos - 1U ) );
+				pos = cell_end + 2U;
+			}
+			return true;
+		}
+
+		/***
+		 * Classify a cell by its characters.  Integers too long to be parsed
+		 * without overflow are Real
+		 */
+		[[nodiscard]] inline sniffed_type classify_cell( std::string_view cell ) {
+			auto first = skip_blanks( cell.data( ), cell.data( ) + cell.size( ) );
+			auto last = cell.data( ) + cell.size( );
+			while( last != first and ( last[-1] == ' ' or last[-1] == '\t' ) ) {
+				--last;
+			}
+			auto skip_digits = [&last]( char const *ptr ) {
+				while( ptr != last and is_digit( *ptr ) ) {
+					++ptr;
+				}
+				return ptr;
+			};
+			bool const is_negative = first != last and *first == '-';
+			if( first != last and ( *first == '-' or *first == '+' ) ) {
+				++first;
+			}
+			auto ptr = skip_digits( first );
+			auto const int_digits = static_cast<std::size_t>( ptr - first );
+			if( ptr == last ) {
+				if( int_digits == 0 ) {
+					return sniffed_type::String;
+				}
+				if( int_digits <= 18U ) {
+					return is_negative ? sniffed_type::Signed : sniffed_type::Unsigned;
+				}
+				return int_digits <= 19U and not is_negative ? sniffed_type::Unsigned
+				                                             : sniffed_type::Real;
+			}
+			auto frac_digits = std::size_t{0};
+			if( *ptr == '.' ) {
+				auto const frac_first = ptr + 1;
+				ptr = skip_digits( frac_first );
+				frac_digits = static_cast<std::size_t>( ptr - frac_first );
+			}
+			if( int_digits + frac_digits == 0 ) {
+				return sniffed_type::String;
+			}
+			if( ptr != last and ( *ptr == 'e' or *ptr == 'E' ) ) {
+				++ptr;
+				if( ptr != last and ( *ptr == '-' or *ptr == '+' ) ) {
+					++ptr;
+				}
+				auto const exp_first = ptr;
+				ptr = skip_digits( exp_first );
+				if( ptr == exp_first ) {
+					return sniffed_type::String;
+				}
+			}
+			return ptr == last ? sniffed_type::Real : sniffed_type::String;
+		}
+	} // namespace text_table_details
+
+	/***
+	 * Infer the dialect, header presence and column types of a table from the
+	 * start of it.  Only the first max_sample_size characters are used and a
+	 * trailing partial row is ignored
+	 */
+	[[maybe_unused, nodiscard]] inline table_descriptor sniff_table(
+	  std::string_view sample,
+	  std::size_t max_sample_size = text_table_details::default_sniff_size ) {
+		using namespace text_table_details;
+		sample = sample.substr( 0, max_sample_size );
+		auto const chars = sniff_characters( sample );
+
+		// End the sample after the last newline that is not in a quoted cell
+		std::size_t rows_end = 0;
+		for( std::size_t pos = 0; pos < sample.size( ); ) {
+			auto const row_end =
+			  pos + structural::find_row_end( sample.data( ) + pos,
+			                                  sample.data( ) + sample.size( ),
+			                                  chars.quote, '\n' );
+			if( row_end >= sample.size( ) ) {
+				break;
+			}
+			pos = row_end + 1U;
+			rows_end = pos;
+		}
+		auto terminated = std::string( );
+		if( rows_end > 0 ) {
+			sample = sample.substr( 0, rows_end );
+		} else {
+			// A single partial row
+			terminated.reserve( sample.size( ) + 1U );
+			terminated.append( sample.data( ), sample.size( ) );
+			terminated.push_back( '\n' );
+			sample = terminated;
+		}
+
+		auto result = table_descriptor{};
+		result.dialect.quote = chars.quote;
+		result.line_endings = chars.crlf ? line_ending::CrLf : line_ending::Lf;
+		result.dialect.delimiter = sniff_delimiter( sample, chars.quote );
+
+		auto header = std::vector<std::string_view>( );
+		auto header_types = std::vector<sniffed_type>( );
+		auto &types = result.column_types;
+		auto seen = std::vector<bool>( );
+		auto cells = std::vector<std::string_view>( );
+		bool is_first_row = true;
+		for( std::size_t pos = 0; pos < sample.size( ); ) {
+			auto const row_size = structural::find_row_end(
+			  sample.data( ) + pos, sample.data( ) + sample.size( ), chars.quote,
+			  '\n' );
+			auto const row = sample.substr( pos, row_size );
+			pos += row_size + 1U;
+			// Malformed rows are not evidence of the layout
+			if( not split_sniffed_row( row, result.dialect.delimiter, chars.quote,
+			                           cells ) or
+			    cells.empty( ) ) {
+				continue;
+			}
+			for( std::size_t col = 0; col < cells.size( ); ++col ) {
+				auto const cell = cells[col];
+				auto const type = classify_cell( cell );
+				if( is_first_row ) {
+					header.push_back( cell );
+					header_types.push_back( type );
+				} else if( not cell.empty( ) ) {
+					if( col >= types.size( ) ) {
+						types.resize( col + 1U, sniffed_type::Unsigned );
+						seen.resize( col + 1U, false );
+					}
+					types[col] = seen[col] ? std::max( types[col], type ) : type;
+					seen[col] = true;
+				}
+			}
+			is_first_row = false;
+		}
+		types.resize( std::max( types.size( ), header.size( ) ),
+		              sniffed_type::String );
+		seen.resize( types.size( ), false );
+		for( std::size_t n = 0; n < types.size( ); ++n ) {
+			if( not seen[n] ) {
+				types[n] = sniffed_type::String;
+			}
+		}
+
+		// A header is likely when a numeric column has a non-numeric first row.
+		// Without numeric columns assume one if the names are distinct
+		bool has_numeric_column = false;
+		bool header_differs = false;
+		for( std::size_t n = 0; n < header.size( ); ++n ) {
+			if( types[n] != sniffed_type::String ) {
+				has_numeric_column = true;
+				header_differs = header_differs or
+				                 ( not header[n].empty( ) and
+				                   header_types[n] == sniffed_type::String );
+			}
+		}
+		if( has_numeric_column ) {
+			result.has_header = header_differs;
+		} else {
+			auto names = header;
+			std::sort( names.begin( ), names.end( ) );
+			result.has_header =
+			  std::adjacent_find( names.begin( ), names.end( ) ) == names.end( ) and
+			  std::find( names.begin( ), names.end( ), std::string_view( ) ) ==
+			    names.end( );
+		}
+		if( not result.has_header ) {
+			for( std::size_t n = 0; n < header.size( ); ++n ) {
+				if( not header[n].empty( ) ) {
+					types[n] =
+					  seen[n] ? std::max( types[n], header_types[n] ) : header_types[n];
+				}
+			}
+		}
+		return result;
+	}
+} // namespace daw::text_data
@@ -0,0 +1,276 @@
+// The MIT License (MIT)
+//
+// Copyright (c) Darrell Wright
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and / or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include "daw_text_table_link.h"
+#include "impl/daw_csv_table.h"
+#include "impl/daw_text_table_assert.h"
+#include "impl/daw_text_table_link_common.h"
+#include "impl/daw_text_table_link_table_state.h"
+
+#include <daw/daw_string_view.h>
+
+#include <array>
+#include <cstddef>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+namespace daw::text_data {
+	namespace text_table_details {
+		struct no_static_key {};
+
+		template<typename T, std::size_t KeyIndex,
+		         bool HasKey = KeyIndex != no_column_index>
+		struct static_key_type {
+			using type = no_static_key;
+		};
+
+		template<typename T, std::size_t KeyIndex>
+		struct static_key_type<T, KeyIndex, true> {
+			using type = typename text_table_data_contract_trait_t<
+			  T>::template column_t<KeyIndex>::parse_to;
+		};
+	} // namespace text_table_details
+
+	/***
+	 * A table with a fixed capacity that can be parsed at compile time, e.g.
+	 * from a string literal, so that it costs nothing at startup.  The
+	 * columns must have constexpr parsers such as text_number and
+	 * text_string_raw.  With a KeyIndex the keys are kept in order so that
+	 * rows are found by a binary search
+	 * @tparam T type of row with a text_data_contract, it must be default
+	 * constructible
+	 * @tparam MaxRows the capacity, a table with more rows is an error
+	 * @tparam KeyIndex index in the text_column_list of the key column
+	 */
+	template<typename T, std::size_t MaxRows,
+	         std::size_t KeyIndex = text_table_details::no_column_index>
+	class static_csv_table {
+		static_assert( std::is_default_constructible_v<T>,
+		               "The rows are stored in a std::array" );
+
+		using parser_t = text_table_details::text_table_data_contract_trait_t<T>;
+		static_assert( text_table_details::check_arena_container<parser_t>( ) );
+
+	public:
+		using value_type = T;
+		using size_type = std::size_t;
+		using const_iterator = T const *;
+		using key_type =
+		  typename text_table_details::static_key_type<T, KeyIndex>::type;
+		static constexpr bool has_key =
+		  KeyIndex != text_table_details::no_column_index;
+
+	private:
+		std::array<T, MaxRows> m_rows{};
+		// The keys in ascending order and the row each belongs to
+		std::array<key_type, has_key ? MaxRows : 0> m_keys{};
+		std::array<std::size_t, has_key ? MaxRows : 0> m_order{};
+		std::size_t m_size = 0;
+
+		// Equal keys are ordered by their row, so the first row with a key is
+		// the one found
+		constexpr bool order_less( std::size_t lhs, std::size_t rhs,
+		                           std::array<key_type, MaxRows> const &keys ) {
+			if( keys[lhs] < keys[rhs] ) {
+				return true;
+			}
+			return not( keys[rhs] < keys[lhs] ) and lhs < rhs;
+		}
+
+		constexpr void sift_down( std::size_t first, std::size_t count,
+		                          std::array<key_type, MaxRows> const &keys ) {
+			auto parent = first;
+			for( auto child = 2U * parent + 1U; child < count;
+			     child = 2U * parent + 1U ) {
+				if( child + 1U < count and
+				    order_less( m_order[child], m_order[child + 1U], keys ) ) {
+					++child;
+				}
+				if( not order_less( m_order[parent], m_order[child], keys ) ) {
+					return;
+				}
+				auto const tmp = m_order[parent];
+				m_order[parent] = m_order[child];
+				m_order[child] = tmp;
+				parent = child;
+			}
+		}
+
+		/***
+		 * Heap sort the rows by key, std::sort is not constexpr in C++17
+		 */
+		constexpr void sort_keys( std::array<key_type, MaxRows> const &keys ) {
+			for( std::size_t n = 0; n < m_size; ++n ) {
+				m_order[n] = n;
+			}
+			for( auto n = m_size / 2U; n-- > 0; ) {
+				sift_down( n, m_size, keys );
+			}
+			for( auto count = m_size; count > 1U; --count ) {
+				auto const tmp = m_order[0];
+				m_order[0] = m_order[count - 1U];
+				m_order[count - 1U] = tmp;
+				sift_down( 0, count - 1U, keys );
+			}
+			for( std::size_t n = 0; n < m_size; ++n ) {
+				m_keys[n] = keys[m_order[n]];
+			}
+		}
+
+	public:
+		constexpr static_csv_table( ) = default;
+
+		template<typename TableType>
+		constexpr static_csv_table(
+		  daw::basic_string_view<typename TableType::CharT> rng,
+		  TableType const &table ) {
+			using location_t = typename parser_t::template location_type<TableType>;
+			auto state = TableState<TableType>( rng, table );
+			auto loc_info = parser_t::template location_info<TableType>( state );
+			auto keys = std::array<key_type, has_key ? MaxRows : 0>{};
+			while( not state.at_eof( ) ) {
+				daw_text_table_assert( m_size < MaxRows,
+				                       "The table has more than MaxRows rows" );
+				text_table_details::read_row_cells( state, loc_info );
+				m_rows[m_size] =
+				  parser_t::template construct_row<T>( loc_info, state.table( ) );
+				if constexpr( has_key ) {
+					static_assert( KeyIndex < location_t::ignored.size( ),
+					               "KeyIndex must be the index of a column in the list" );
+					static_assert( not location_t::ignored[KeyIndex],
+					               "The key column cannot be ignored" );
+					keys[m_size] = text_table_details::parse_cell<
+					  typename parser_t::template column_t<KeyIndex>, KeyIndex,
+					  location_t, TableType>( loc_info, state.table( ) );
+				}
+				state.row_move_to_next( );
+				++m_size;
+			}
+			if constexpr( has_key ) {
+				sort_keys( keys );
+			}
+		}
+
+		[[nodiscard]] constexpr std::size_t size( ) const {
+			return m_size;
+		}
+
+		[[nodiscard]] static constexpr std::size_t capacity( ) {
+			return MaxRows;
+		}
+
+		[[nodiscard]] constexpr bool empty( ) const {
+			return m_size == 0;
+		}
+
+		[[nodiscard]] constexpr T const &operator[]( std::size_t idx ) const {
+			return m_rows[idx];
+		}
+
+		[[nodiscard]] constexpr T const *data( ) const {
+			return m_rows.data( );
+		}
+
+		[[nodiscard]] constexpr const_iterator begin( ) const {
+			return m_rows.data( );
+		}
+
+		[[nodiscard]] constexpr const_iterator end( ) const {
+			return m_rows.data( ) + m_size;
+		}
+
+		/***
+		 * Find the first row with the key
+		 * @return the row, or nullptr when no row has the key
+		 */
+		template<typename Key, bool B = has_key,
+		         std::enable_if_t<B, std::nullptr_t> = nullptr>
+		[[nodiscard]] constexpr T const *find( Key const &key ) const {
+			std::size_t first = 0;
+			std::size_t count = m_size;
+			while( count > 0 ) {
+				auto const step = count / 2U;
+				if( m_keys[first + step] < key ) {
+					first += step + 1U;
+					count -= step + 1U;
+				} else {
+					count = step;
+				}
+			}
+			if( first == m_size or key < m_keys[first] ) {
+				return nullptr;
+			}
+			return m_rows.data( ) + m_order[first];
+		}
+
+		template<typename Key, bool B = has_key,
+		         std::enable_if_t<B, std::nullptr_t> = nullptr>
+		[[nodiscard]] constexpr bool contains( Key const &key ) const {
+			return find( key ) != nullptr;
+		}
+	};
+
+	/***
+	 * Parse a csv table into a static_csv_table.  When rng is a constant, such
+	 * as a string literal, the result can be constexpr
+	 * @tparam T type of row with a text_data_contract
+	 * @tparam MaxRows capacity of the table
+	 * @tparam KeyIndex index in the text_column_list of the key column, if any
+	 */
+	template<typename T, std::size_t MaxRows,
+	         std::size_t KeyIndex = text_table_details::no_column_index>
+	[[maybe_unused, nodiscard]] constexpr static_csv_table<T, MaxRows, KeyIndex>
+	parse_csv_table_static( std::basic_string_view<char> rng ) {
+		return static_csv_table<T, MaxRows, KeyIndex>(
+		  daw::basic_string_view<char>( rng.data( ), rng.size( ) ),
+		  basic_csv_table_type<char>{} );
+	}
+
+	template<typename T, std::size_t MaxRows,
+	         std::size_t KeyIndex = text_table_details::no_column_index>
+	[[maybe_unused, nodiscard]] constexpr static_csv_table<T, MaxRows, KeyIndex>
+	parse_csv_table_static( std::basic_string_view<wchar_t> rng ) {
+		return static_csv_table<T, MaxRows, KeyIndex>(
+		  daw::basic_string_view<wchar_t>( rng.data( ), rng.size( ) ),
+		  basic_csv_table_type<wchar_t>{} );
+	}
+
+	/***
+	 * Parse a table into a static_csv_table using an explicit table type
+	 */
+	template<typename T, std::size_t MaxRows,
+	         std::size_t KeyIndex = text_table_details::no_column_index,
+	         typename TableType,
+	         std::enable_if_t<text_table_details::is_a_table_type_v<TableType>,
+	                          std::nullptr_t> = nullptr>
+	[[maybe_unused, nodiscard]] constexpr static_csv_table<T, MaxRows, KeyIndex>
+	parse_csv_table_static( std::basic_string_view<typename TableType::CharT> rng,
+	                        TableType const &table ) {
+		return static_csv_table<T, MaxRows, KeyIndex>(
+		  daw::basic_string_view<typename TableType::CharT>( rng.data( ),
+		                                                     rng.size( ) ),
+		  table );
+	}
+} // namespace daw::text_data
@@ -0,0 +1,222 @@
+// The MIT License (MIT)
+//
+// Copyright (c) Darrell Wright
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and / or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include "daw_text_table_link.h"
+#include "impl/daw_csv_table.h"
+#include "impl/daw_text_table_assert.h"
+#include "impl/daw_text_table_link_common.h"
+#include "impl/daw_text_table_link_table_state.h"
+#include "impl/daw_text_table_structural.h"
+
+#include <daw/daw_string_view.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <istream>
+#include <optional>
+#include <string_view>
+#include <vector>
+
+namespace daw::text_data {
+	/***
+	 * Parse a table that arrives in pieces, e.g. from a pipe or a decompressor.
+	 * Input is appended to a fixed size buffer, each complete row is parsed and
+	 * passed to on_row, and the partial row at the end of the buffer is moved to
+	 * the front before more input is accepted.  Memory use is bounded by the
+	 * capacity, which must be larger than the longest row.
+	 *
+	 * Any views in the T passed to on_row refer to the internal buffer and are
+	 * only valid for the duration of the call
+	 * @tparam T type of row with a text_data_contract
+	 */
+	template<typename T, typename TableType = basic_csv_table_type<char>>
+	class streaming_csv_parser {
+		static_assert( not TableType::allow_escaped,
+		               "Escaped quotes make row ends ambiguous" );
+
+		using CharT = typename TableType::CharT;
+		using parser_t = text_table_details::text_table_data_contract_trait_t<T>;
+		using location_type = typename parser_t::template location_type<TableType>;
+		static_assert( text_table_details::check_arena_container<parser_t>( ) );
+
+		TableType m_table;
+		std::vector<CharT> m_buffer;
+		// [0, m_size) holds data, [0, m_rows_end) is the complete rows and
+		// [0, m_scanned) has been searched for row ends
+		std::size_t m_size = 0;
+		std::size_t m_rows_end = 0;
+		std::size_t m_scanned = 0;
+		std::size_t m_complete_rows = 0;
+		bool m_in_quote = false;
+		std::optional<location_type> m_loc_info{};
+
+		void scan( ) {
+			auto const first = m_buffer.data( );
+			while( m_scanned < m_size ) {
+				if( m_scanned == m_rows_end and m_table.has_comment_rows( ) and
+				    first[m_scanned] == m_table.comment_char ) {
+					// Quotes in a comment row do not open a quoted cell
+					auto const row_end = std::find( first + m_scanned, first + m_size,
+					                                TableType::newline_char );
+					if( row_end == first + m_size ) {
+						// The comment row is scanned again when the rest arrives
+						return;
+					}
+					m_scanned = static_cast<std::size_t>( row_end - first ) + 1U;
+					m_rows_end = m_scanned;
+					continue;
+				}
+				auto const pos =
+				  m_scanned + text_table_details::structural::find_row_end(
+				                first + m_scanned, first + m_size,
+				                m_table.quote_char, TableType::newline_char,
+				                m_in_quote );
+				if( pos >= m_size ) {
+					// Remember if the partial row ends inside of a quoted cell
+					m_in_quote = m_in_quote !=
+					             text_table_details::structural::has_odd_quote_count(
+					               first + m_scanned, first + m_size,
+					               m_table.quote_char );
+					m_scanned = m_size;
+					return;
+				}
+				++m_complete_rows;
+				m_in_quote = false;
+				m_scanned = pos + 1U;
+				m_rows_end = m_scanned;
+			}
+		}
+
+		[[nodiscard]] bool is_blank_row( daw::basic_string_view<CharT> rng ) const {
+			auto const first = rng.front( );
+			if( first == TableType::newline_char ) {
+				return true;
+			}
+			return m_table.trim_carriage_return and
+			       first == TableType::carriage_return_char and rng.size( ) > 1U and
+			       rng[1] == TableType::newline_char;
+		}
+
+		template<typename OnRow>
+		void parse_complete_rows( OnRow &on_row ) {
+			if( m_rows_end == 0 ) {
+				return;
+			}
+			auto state = TableState<TableType>(
+			  daw::basic_string_view<CharT>( m_buffer.data( ), m_rows_end ), m_table );
+			if( not m_loc_info ) {
+				if( m_complete_rows < TableType::data_row ) {
+					// Wait for the rest of the header rows
+					return;
+				}
+				m_loc_info = parser_t::template location_info<TableType>( state );
+			}
+			while( not state.at_eof( ) ) {
+				if( is_blank_row( state.remaining( ) ) ) {
+					// e.g. a trailing newline that arrived on its own
+					state.row_move_to_next( );
+					continue;
+				}
+				on_row( parser_t::template parse_row<T>( state, *m_loc_info ) );
+			}
+			std::copy( m_buffer.data( ) + m_rows_end, m_buffer.data( ) + m_size,
+			           m_buffer.data( ) );
+			m_size -= m_rows_end;
+			m_scanned -= m_rows_end;
+			m_rows_end = 0;
+		}
+
+	public:
+		static constexpr std::size_t default_capacity = 1024U * 1024U;
+
+		explicit streaming_csv_parser( std::size_t capacity = default_capacity,
+		                               TableType const &table = TableType{} )
+		  : m_table( table )
+		  , m_buffer( capacity ) {
+			daw_text_table_assert( capacity > 0, "Expected a non-empty buffer" );
+		}
+
+		/***
+		 * Append data to the table and call on_row for each row it completes
+		 */
+		template<typename OnRow>
+		void push( std::basic_string_view<CharT> data, OnRow &&on_row ) {
+			while( not data.empty( ) ) {
+				auto const count = std::min( data.size( ), m_buffer.size( ) - m_size );
+				daw_text_table_assert( count > 0,
+				                       "Row is larger than the stream buffer" );
+				std::copy_n( data.data( ), count, m_buffer.data( ) + m_size );
+				m_size += count;
+				data.remove_prefix( count );
+				scan( );
+				parse_complete_rows( on_row );
+			}
+		}
+
+		/***
+		 * Read is until it is exhausted, calling on_row for each row, and then
+		 * finish the table.  Data is read directly into the stream buffer
+		 */
+		template<typename OnRow>
+		void pull( std::basic_istream<CharT> &is, OnRow &&on_row ) {
+			while( is ) {
+				auto const count = m_buffer.size( ) - m_size;
+				daw_text_table_assert( count > 0,
+				                       "Row is larger than the stream buffer" );
+				is.read( m_buffer.data( ) + m_size,
+				         static_cast<std::streamsize>( count ) );
+				auto const read_count = static_cast<std::size_t>( is.gcount( ) );
+				if( read_count == 0 ) {
+					break;
+				}
+				m_size += read_count;
+				scan( );
+				parse_complete_rows( on_row );
+			}
+			finish( on_row );
+		}
+
+		/***
+		 * Signal the end of the table.  The last row does not need a trailing
+		 * newline.  The parser is ready for a new table afterwards
+		 */
+		template<typename OnRow>
+		void finish( OnRow &&on_row ) {
+			daw_text_table_assert( not m_in_quote, "Unterminated quoted cell" );
+			if( m_size > m_rows_end ) {
+				m_rows_end = m_size;
+				++m_complete_rows;
+			}
+			if( m_size > 0 ) {
+				parse_complete_rows( on_row );
+				daw_text_table_assert( m_loc_info, "Unexpected end of data" );
+			}
+			m_size = 0;
+			m_rows_end = 0;
+			m_scanned = 0;
+			m_complete_rows = 0;
+			m_loc_info.reset( );
+		}
+	};
+} // namespace daw::text_data
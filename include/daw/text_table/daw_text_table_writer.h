@@ -0,0 +1,369 @@
+// The MIT License (MIT)
+//
+// Copyright (c) Darrell Wright
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and / or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include "daw_text_table_link.h"
+#include "daw_text_table_parallel.h"
+#include "impl/daw_csv_table.h"
+#include "impl/daw_text_table_link_common.h"
+#include "impl/daw_text_table_link_formatters.h"
+
+#include <daw/cpp_17.h>
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <future>
+#include <ios>
+#include <iterator>
+#include <string_view>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+namespace daw::text_data {
+	namespace text_table_details {
+		template<typename T>
+		using to_text_data_test = decltype( text_data_contract<T>::to_text_data(
+		  std::declval<T const &>( ) ) );
+
+		/***
+		 * The contract of T has a static to_text_data( T const & ) returning a
+		 * tuple of the values of the mapped columns in column list order, e.g.
+		 * std::forward_as_tuple( value.a, value.b )
+		 */
+		template<typename T>
+		inline constexpr bool has_to_text_data_v =
+		  daw::is_detected_v<to_text_data_test, T>;
+
+		template<typename Sink>
+		using stream_sink_test = decltype( std::declval<Sink &>( ).write(
+		  std::declval<char const *>( ), std::declval<std::streamsize>( ) ) );
+
+		template<typename Sink>
+		using string_sink_test = decltype( std::declval<Sink &>( ).append(
+		  std::declval<char const *>( ), std::declval<std::size_t>( ) ) );
+
+		/***
+		 * A sink is a std::ostream, a std::string that is appended to or a
+		 * callable taking a std::string_view
+		 */
+		template<typename Sink>
+		void write_to_sink( Sink &sink, std::string_view data ) {
+			if constexpr( daw::is_detected_v<stream_sink_test, Sink> ) {
+				sink.write( data.data( ),
+				            static_cast<std::streamsize>( data.size( ) ) );
+			} else if constexpr( daw::is_detected_v<string_sink_test, Sink> ) {
+				sink.append( data.data( ), data.size( ) );
+			} else {
+				sink( data );
+			}
+		}
+
+		template<typename ColumnList>
+		struct row_writer;
+
+		/***
+		 * Columns with a position, e.g. text_column_at, are written at their
+		 * position and the other columns fill the remaining cells in column list
+		 * order.  Ignored columns and cells without a column are written empty
+		 */
+		template<header_match Match, typename... TextTableColumns>
+		struct row_writer<basic_text_column_list<Match, TextTableColumns...>> {
+		private:
+			using location_t = locations_info_t<char, TextTableColumns...>;
+			static constexpr std::size_t column_count = sizeof...( TextTableColumns );
+
+			// The index in the to_text_data tuple of each column
+			static constexpr auto value_index = [] {
+				auto result = std::array<std::size_t, column_count>{};
+				std::size_t count = 0;
+				for( std::size_t n = 0; n < result.size( ); ++n ) {
+					result[n] = count;
+					count += static_cast<std::size_t>( not location_t::ignored[n] );
+				}
+				return result;
+			}( );
+
+			// The cell of the row each column is written to
+			static constexpr auto cell_index = [] {
+				constexpr auto positions =
+				  std::array<std::size_t, column_count>{
+				    column_index_of<TextTableColumns>( )...};
+				auto result = std::array<std::size_t, column_count>{};
+				auto is_used = [&]( std::size_t cell ) {
+					for( auto const pos : positions ) {
+						if( pos == cell ) {
+							return true;
+						}
+					}
+					return false;
+				};
+				std::size_t next_cell = 0;
+				for( std::size_t n = 0; n < column_count; ++n ) {
+					if( positions[n] != no_column_index ) {
+						result[n] = positions[n];
+						continue;
+					}
+					while( is_used( next_cell ) ) {
+						++next_cell;
+					}
+					result[n] = next_cell++;
+				}
+				return result;
+			}( );
+
+			static constexpr std::size_t cell_count = [] {
+				std::size_t result = 0;
+				for( auto const cell : cell_index ) {
+					result = std::max( result, cell + 1U );
+				}
+				return result;
+			}( );
+
+			// The column written to each cell, or no_column_index for an empty one
+			static constexpr auto cell_column = [] {
+				auto result = std::array<std::size_t, cell_count>{};
+				for( auto &col : result ) {
+					col = no_column_index;
+				}
+				for( std::size_t n = 0; n < column_count; ++n ) {
+					result[cell_index[n]] = n;
+				}
+				return result;
+			}( );
+
+			template<std::size_t Cell, typename Values, typename TableType>
+			static void write_cell_at( Values const &values, text_write_buffer &out,
+			                           TableType const &table ) {
+				if constexpr( Cell > 0 ) {
+					out.append( table.delimiter_char );
+				}
+				constexpr auto col = cell_column[Cell];
+				if constexpr( col != no_column_index ) {
+					using column_t =
+					  std::tuple_element_t<col, std::tuple<TextTableColumns...>>;
+					if constexpr( not is_ignored_column_v<column_t> ) {
+						write_cell<column_t>( std::get<value_index[col]>( values ), out,
+						                      table, Cell == 0 );
+					}
+				}
+			}
+
+			template<typename T, typename TableType, std::size_t... Cells>
+			static void write_row( T const &value, text_write_buffer &out,
+			                       TableType const &table,
+			                       std::index_sequence<Cells...> ) {
+				auto const values = text_data_contract<T>::to_text_data( value );
+				static_assert( std::tuple_size_v<decltype( values )> ==
+				                 location_t::mapped_count,
+				               "to_text_data must return a value for each column that "
+				               "is not ignored" );
+				( write_cell_at<Cells>( values, out, table ), ... );
+				out.append( '\n' );
+			}
+
+		public:
+			template<typename TableType>
+			static void write_header( text_write_buffer &out,
+			                          TableType const &table ) {
+				auto const names = std::array<daw::string_view, column_count>{
+				  daw::string_view( TextTableColumns::name )...};
+				for( std::size_t cell = 0; cell < cell_count; ++cell ) {
+					if( cell > 0 ) {
+						out.append( table.delimiter_char );
+					}
+					if( auto const col = cell_column[cell]; col != no_column_index ) {
+						write_string_cell(
+						  std::string_view( names[col].data( ), names[col].size( ) ), out,
+						  table, cell == 0 );
+					}
+				}
+				out.append( '\n' );
+			}
+
+			template<typename T, typename TableType>
+			static void write_row( T const &value, text_write_buffer &out,
+			                       TableType const &table ) {
+				write_row( value, out, table, std::make_index_sequence<cell_count>{} );
+			}
+		};
+	} // namespace text_table_details
+
+	/***
+	 * Writes tables of T in the layout of its text_data_contract, the inverse
+	 * of parse_csv_table.  The contract must also have a to_text_data, see
+	 * has_to_text_data_v.  Rows are formatted into a buffer that is passed to
+	 * the sink each time it fills and is reused by later writes
+	 * @tparam T type of row with a text_data_contract
+	 */
+	template<typename T, typename TableType = basic_csv_table_type<char>>
+	class csv_table_writer {
+		static_assert( std::is_same_v<typename TableType::CharT, char>,
+		               "Tables are written as bytes" );
+		static_assert( text_table_details::has_to_text_data_v<T>,
+		               "The text_data_contract needs a to_text_data" );
+
+		using row_writer_t = text_table_details::row_writer<
+		  text_table_details::text_table_data_contract_trait_t<T>>;
+
+		TableType m_table;
+		std::size_t m_buffer_size;
+		text_table_details::text_write_buffer m_buffer;
+		// Buffers of the threads of write_parallel, kept for reuse
+		std::vector<text_table_details::text_write_buffer> m_thread_buffers{};
+
+		template<typename Sink>
+		void flush( Sink &sink ) {
+			text_table_details::write_to_sink( sink, m_buffer.view( ) );
+			m_buffer.clear( );
+		}
+
+		template<typename Sink>
+		void write_header( Sink &sink ) {
+			if constexpr( TableType::has_header ) {
+				row_writer_t::write_header( m_buffer, m_table );
+				flush( sink );
+			}
+		}
+
+	public:
+		static constexpr std::size_t default_buffer_size = 1024U * 1024U;
+		// The rows formatted by each thread at a time in write_parallel
+		static constexpr std::size_t parallel_block_rows = 16384U;
+
+		/***
+		 * @param buffer_size amount of output collected before it is passed to
+		 * the sink
+		 */
+		explicit csv_table_writer( std::size_t buffer_size = default_buffer_size,
+		                           TableType const &table = TableType{} )
+		  : m_table( table )
+		  , m_buffer_size( buffer_size )
+		  , m_buffer( buffer_size ) {}
+
+		/***
+		 * Write a header row, if the table type has one, followed by a row for
+		 * each element of rows
+		 * @param sink a std::ostream, a std::string to append to or a callable
+		 * taking a std::string_view
+		 */
+		template<typename Range, typename Sink>
+		void write( Range const &rows, Sink &&sink ) {
+			write_header( sink );
+			for( auto const &row : rows ) {
+				row_writer_t::write_row( row, m_buffer, m_table );
+				if( m_buffer.size( ) >= m_buffer_size ) {
+					flush( sink );
+				}
+			}
+			flush( sink );
+		}
+
+		/***
+		 * Write the same output as write, formatting blocks of rows on
+		 * thread_count threads.  The blocks are passed to the sink in order as
+		 * each group of thread_count blocks completes
+		 * @param rows a random access range
+		 */
+		template<typename Range, typename Sink>
+		void write_parallel(
+		  Range const &rows, Sink &&sink,
+		  std::size_t thread_count = text_table_details::default_thread_count( ) ) {
+			thread_count = std::max( thread_count, std::size_t{1} );
+			while( m_thread_buffers.size( ) < thread_count ) {
+				m_thread_buffers.emplace_back( m_buffer_size );
+			}
+			write_header( sink );
+			auto const first = std::begin( rows );
+			auto const row_count = static_cast<std::size_t>( std::size( rows ) );
+			auto format_block = [&]( std::size_t block, std::size_t buffer ) {
+				auto &out = m_thread_buffers[buffer];
+				out.clear( );
+				auto const block_first = block * parallel_block_rows;
+				auto const block_last =
+				  std::min( block_first + parallel_block_rows, row_count );
+				for( auto n = block_first; n < block_last; ++n ) {
+					row_writer_t::write_row(
+					  first[static_cast<std::ptrdiff_t>( n )], out, m_table );
+				}
+			};
+			auto const block_count =
+			  ( row_count + parallel_block_rows - 1U ) / parallel_block_rows;
+			auto tasks = std::vector<std::future<void>>( );
+			for( std::size_t block = 0; block < block_count; block += thread_count ) {
+				auto const group_size = std::min( thread_count, block_count - block );
+				tasks.clear( );
+				for( std::size_t n = 1; n < group_size; ++n ) {
+					tasks.push_back(
+					  std::async( std::launch::async, format_block, block + n, n ) );
+				}
+				format_block( block, 0 );
+				for( auto &task : tasks ) {
+					task.get( );
+				}
+				for( std::size_t n = 0; n < group_size; ++n ) {
+					text_table_details::write_to_sink( sink,
+					                                   m_thread_buffers[n].view( ) );
+				}
+			}
+		}
+	};
+
+	/***
+	 * Write rows as a csv table with a header row
+	 * @tparam T type of row with a text_data_contract that has a to_text_data
+	 * @param sink a std::ostream, a std::string to append to or a callable
+	 * taking a std::string_view
+	 */
+	template<typename T, typename Range, typename Sink>
+	void write_csv_table( Range const &rows, Sink &&sink ) {
+		csv_table_writer<T>( ).write( rows, sink );
+	}
+
+	/***
+	 * Write rows in the given dialect
+	 */
+	template<typename T, typename Range, typename Sink, typename Dialect,
+	         std::enable_if_t<text_table_details::is_dialect_v<Dialect>,
+	                          std::nullptr_t> = nullptr>
+	void write_csv_table( Range const &rows, Sink &&sink,
+	                      Dialect const &dialect ) {
+		using table_type = basic_dialect_table_type<char, Dialect>;
+		csv_table_writer<T, table_type>(
+		  csv_table_writer<T, table_type>::default_buffer_size,
+		  table_type( dialect ) )
+		  .write( rows, sink );
+	}
+
+	/***
+	 * Write rows as a csv table, formatting them on thread_count threads
+	 * @param rows a random access range
+	 */
+	template<typename T, typename Range, typename Sink>
+	void write_csv_table_parallel(
+	  Range const &rows, Sink &&sink,
+	  std::size_t thread_count = text_table_details::default_thread_count( ) ) {
+		csv_table_writer<T>( ).write_parallel( rows, sink, thread_count );
+	}
+} // namespace daw::text_data
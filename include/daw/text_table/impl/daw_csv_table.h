@@ -22,8 +22,10 @@
 
 #pragma once
 
+#include "daw_text_table_dialect.h"
 #include "daw_text_table_link_common.h"
 #include "daw_text_table_link_parsers.h"
+#include "daw_text_table_structural.h"
 
 #include <daw/daw_string_view.h>
 #include <daw/daw_utility.h>
@@ -35,77 +37,94 @@ namespace daw::text_data {
 	inline static constexpr std::size_t NoHeaderRow =
 	  std::numeric_limits<std::size_t>::max( );
 
+	/***
+	 * A delimiter separated table
+	 * @tparam Dialect a text_dialect for a dialect known at compile time or
+	 * runtime_dialect.  A runtime_dialect is passed to the constructor
+	 */
 	template<typename CharType, std::size_t HeaderRow = 0,
 	         std::size_t DataRow = HeaderRow + 1U,
 	         bool SkipLeadingWhiteSpace = false, bool EnsureCommaInRow = true,
-	         bool AllowEscaped = false>
-	struct basic_csv_table_type {
-		static_assert( NoHeaderRow or DataRow > HeaderRow,
+	         bool AllowEscaped = false, typename Dialect = csv_dialect>
+	struct basic_csv_table_type
+	  : text_table_details::dialect_chars<CharType, Dialect> {
+		static_assert( HeaderRow == NoHeaderRow or DataRow > HeaderRow,
 		               "Header Row must preceed data" );
 
+	private:
+		using dialect_chars_t = text_table_details::dialect_chars<CharType, Dialect>;
+
+	public:
 		using i_am_a_table_type = void;
 		using CharT = CharType;
-		static constexpr CharT delimiter_char = static_cast<CharT>( ',' );
-		static constexpr CharT quote_char = static_cast<CharT>( '"' );
+		using dialect_type = Dialect;
+		using dialect_chars_t::comment_char;
+		using dialect_chars_t::delimiter_char;
+		using dialect_chars_t::escape_char;
+		using dialect_chars_t::quote_char;
+		using dialect_chars_t::trim_carriage_return;
 		static constexpr CharT zero_char = static_cast<CharT>( '0' );
 		static constexpr CharT newline_char = static_cast<CharT>( '\n' );
-		static constexpr CharT escape_char = static_cast<CharT>( '\\' );
+		static constexpr CharT carriage_return_char = static_cast<CharT>( '\r' );
 		static constexpr bool has_header = HeaderRow != NoHeaderRow;
+		static constexpr bool allow_escaped = AllowEscaped;
+		static constexpr bool skip_leading_whitespace = SkipLeadingWhiteSpace;
+		static constexpr bool ensure_delimiter_in_row = EnsureCommaInRow;
+		static constexpr std::size_t data_row = DataRow;
 
-		static constexpr void
-		row_move_to_next( daw::basic_string_view<CharT> &rng ) {
+		constexpr basic_csv_table_type( ) = default;
+		explicit constexpr basic_csv_table_type( Dialect const &dialect )
+		  : dialect_chars_t( dialect ) {}
 
-			bool is_escaped = false;
-			bool in_quote = false;
-			auto const sz = rng.size( );
+		/***
+		 * Comment rows have to be found row by row
+		 */
+		[[nodiscard]] constexpr bool has_comment_rows( ) const {
+			return comment_char != static_cast<CharT>( '\0' );
+		}
 
-			for( std::size_t n = 0; n < sz; ++n ) {
-				if constexpr( AllowEscaped ) {
-					if( is_escaped ) {
-						is_escaped = false;
-						continue;
-					}
-				}
-				auto const c = rng[n];
-				if constexpr( AllowEscaped ) {
-					if( c == escape_char ) {
-						is_escaped = true;
-						continue;
-					}
-				}
-				if( c == quote_char ) {
-					if( ( sz - n ) > 0 and rng[n + 1] == quote_char ) {
-						++n;
-						continue;
-					}
-					in_quote = not in_quote;
-					continue;
+		constexpr void skip_comment_rows( daw::basic_string_view<CharT> &rng ) const {
+			if( has_comment_rows( ) ) {
+				while( not rng.empty( ) and rng.front( ) == comment_char ) {
+					(void)rng.pop_front( {&newline_char, 1} );
 				}
-				if( c == newline_char ) {
-					rng.remove_prefix( n + 1 );
-					if constexpr( EnsureCommaInRow ) {
-						if( rng.find( delimiter_char ) ==
-						    daw::basic_string_view<CharT>::npos ) {
-
-							rng.remove_prefix( rng.size( ) );
-						}
-					}
-					return;
+			}
+		}
+
+		constexpr void row_move_to_next( daw::basic_string_view<CharT> &rng ) const {
+			auto const pos = find_row_end( rng );
+			if( pos >= rng.size( ) ) {
+				// Last row without a trailing newline
+				rng.remove_prefix( rng.size( ) );
+				return;
+			}
+			rng.remove_prefix( pos + 1 );
+			skip_comment_rows( rng );
+			if constexpr( EnsureCommaInRow ) {
+				if( rng.find( delimiter_char ) == daw::basic_string_view<CharT>::npos ) {
+					rng.remove_prefix( rng.size( ) );
 				}
 			}
 		}
 
-		static constexpr std::size_t
-		row_move_to_header( daw::basic_string_view<CharT> &rng ) {
+		constexpr std::size_t
+		row_move_to_header( daw::basic_string_view<CharT> &rng ) const {
+			if constexpr( not has_header ) {
+				// The data rows are found from the start of the table
+				(void)rng;
+				return 0;
+			}
 			// Assumes that there is no escaping prior to header data
+			skip_comment_rows( rng );
 			for( size_t n = 0; n < HeaderRow; ++n ) {
 				(void)rng.pop_front( {&newline_char, 1} );
+				skip_comment_rows( rng );
 			}
 			return HeaderRow;
 		}
 
-		static constexpr std::size_t
-		row_move_to_data( daw::basic_string_view<CharT> &rng ) {
+		constexpr std::size_t
+		row_move_to_data( daw::basic_string_view<CharT> &rng ) const {
 			auto skip_rows = has_header ? DataRow - HeaderRow : DataRow;
 			daw_text_table_assert( skip_rows == 0 or not rng.empty( ),
 			                       "Unexpected end of data" );
@@ -114,15 +133,28 @@ namespace daw::text_data {
 					row_move_to_next( rng );
 				} else {
 					(void)rng.pop_front( {&newline_char, 1} );
+					skip_comment_rows( rng );
 				}
 			}
 			return DataRow;
 		}
 
-		static constexpr daw::basic_string_view<CharT>
-		column_get_next( daw::basic_string_view<CharT> &rng ) {
+		constexpr daw::basic_string_view<CharT>
+		column_get_next( daw::basic_string_view<CharT> &rng ) const {
+			bool is_escaped = false;
+			return column_get_next( rng, is_escaped );
+		}
+
+		/***
+		 * @param is_escaped set to whether the cell has a doubled quote or, when
+		 * AllowEscaped, an escape_char that has to be removed to get its value
+		 */
+		constexpr daw::basic_string_view<CharT>
+		column_get_next( daw::basic_string_view<CharT> &rng,
+		                 bool &is_escaped ) const {
 			daw_text_table_assert( not rng.empty( ), "Unexpected end of data" );
 
+			is_escaped = false;
 			auto first = rng.begin( );
 			if constexpr( SkipLeadingWhiteSpace ) {
 				trim_left( rng );
@@ -132,32 +164,96 @@ namespace daw::text_data {
 				  first, static_cast<std::size_t>( rng.begin( ) - first ) );
 			}
 			if( rng.front( ) == quote_char ) {
-				return find_end_of_quoted_cell( first, rng );
+				return find_end_of_quoted_cell( first, rng, is_escaped );
+			}
+			return find_end_of_unquoted_cell( rng, is_escaped );
+		}
+
+		/***
+		 * Move past the next count cells of the row without building views of
+		 * them.  Stops at the newline if the row has fewer cells
+		 */
+		constexpr void column_skip( daw::basic_string_view<CharT> &rng,
+		                            std::size_t count ) const {
+			if( count == 0 ) {
+				return;
+			}
+			if constexpr( use_structural ) {
+				if( not text_table_details::is_constant_evaluated( ) ) {
+					rng.remove_prefix( text_table_details::structural::skip_cells(
+					  rng.data( ), rng.data( ) + rng.size( ), quote_char,
+					  delimiter_char, newline_char, count ) );
+					return;
+				}
+			}
+			for( ; count > 0 and not rng.empty( ); --count ) {
+				(void)column_get_next( rng );
 			}
-			return find_end_of_unquoted_cell( first, rng );
 		}
 
 	private:
-		template<typename First>
-		static constexpr daw::basic_string_view<CharT>
-		find_end_of_unquoted_cell( First first,
-		                           daw::basic_string_view<CharT> &rng ) {
+		static constexpr bool use_structural =
+		  not AllowEscaped and
+		  text_table_details::structural::is_enabled_for<CharT>;
+
+		/***
+		 * Find the newline ending the current row, skipping quoted newlines
+		 * @return position of the newline or rng.size( ) if there is none
+		 */
+		constexpr std::size_t
+		find_row_end( daw::basic_string_view<CharT> rng ) const {
+			if constexpr( use_structural ) {
+				if( not text_table_details::is_constant_evaluated( ) ) {
+					return text_table_details::structural::find_row_end(
+					  rng.data( ), rng.data( ) + rng.size( ), quote_char,
+					  newline_char );
+				}
+			}
 			bool is_escaped = false;
-			auto pos = rng.find_first_of_if( [&]( CharT c ) {
+			bool in_quote = false;
+			auto const sz = rng.size( );
+
+			for( std::size_t n = 0; n < sz; ++n ) {
 				if constexpr( AllowEscaped ) {
 					if( is_escaped ) {
 						is_escaped = false;
-						return false;
+						continue;
 					}
-					is_escaped = c == escape_char;
 				}
-				return c == delimiter_char or c == newline_char;
-			} );
-			if( pos == daw::basic_string_view<CharT>::npos ) {
-				pos = rng.size( );
+				auto const c = rng[n];
+				if constexpr( AllowEscaped ) {
+					if( c == escape_char ) {
+						is_escaped = true;
+						continue;
+					}
+				}
+				if( c == quote_char ) {
+					if( n + 1 < sz and rng[n + 1] == quote_char ) {
+						++n;
+						continue;
+					}
+					in_quote = not in_quote;
+					continue;
+				}
+				if( c == newline_char and not in_quote ) {
+					return n;
+				}
 			}
+			return sz;
+		}
+
+		constexpr daw::basic_string_view<CharT>
+		find_end_of_unquoted_cell( daw::basic_string_view<CharT> &rng,
+		                           bool &is_escaped ) const {
+			auto pos = find_cell_end( rng, is_escaped );
+			auto result = daw::basic_string_view<CharT>( rng.data( ), pos );
 			rng.remove_prefix( pos );
-			auto result = daw::basic_string_view<CharT>( first, pos );
+			if( trim_carriage_return and pos > 0 and
+			    ( rng.empty( ) or rng.front( ) == newline_char ) and
+			    rng.data( )[-1] == carriage_return_char ) {
+				// The last cell of a \r\n terminated row
+				result.remove_suffix( 1 );
+			}
 
 			if( not rng.empty( ) and rng.front( ) == delimiter_char ) {
 				rng.remove_prefix( );
@@ -165,15 +261,55 @@ namespace daw::text_data {
 			return result;
 		}
 
+		/***
+		 * Find the delimiter or newline ending an unquoted cell
+		 * @return position of the terminator or rng.size( ) if there is none
+		 */
+		constexpr std::size_t find_cell_end( daw::basic_string_view<CharT> rng,
+		                                     bool &has_escape ) const {
+			if constexpr( use_structural ) {
+				if( not text_table_details::is_constant_evaluated( ) ) {
+					return text_table_details::structural::find_cell_end(
+					  rng.data( ), rng.data( ) + rng.size( ), delimiter_char,
+					  newline_char );
+				}
+			}
+			bool is_escaped = false;
+			auto const pos = rng.find_first_of_if( [&]( CharT c ) {
+				if constexpr( AllowEscaped ) {
+					if( is_escaped ) {
+						is_escaped = false;
+						return false;
+					}
+					is_escaped = c == escape_char;
+					has_escape = has_escape or is_escaped;
+				}
+				return c == delimiter_char or c == newline_char;
+			} );
+			if( pos == daw::basic_string_view<CharT>::npos ) {
+				return rng.size( );
+			}
+			return pos;
+		}
+
 		template<typename First>
-		static constexpr daw::basic_string_view<CharT>
-		find_end_of_quoted_cell( First first, daw::basic_string_view<CharT> &rng ) {
+		constexpr daw::basic_string_view<CharT>
+		find_end_of_quoted_cell( First first, daw::basic_string_view<CharT> &rng,
+		                         bool &is_escaped ) const {
 			rng.remove_prefix( );
 			first = rng.begin( );
 			while( not rng.empty( ) ) {
+				if constexpr( AllowEscaped ) {
+					if( rng.front( ) == escape_char and rng.size( ) > 1 ) {
+						is_escaped = true;
+						rng.remove_prefix( 2 );
+						continue;
+					}
+				}
 				if( rng.front( ) == quote_char ) {
 					if( rng.size( ) > 1 and rng[1] == quote_char ) {
 						// Escaped Quote
+						is_escaped = true;
 						rng.remove_prefix( );
 					} else {
 						break;
@@ -188,19 +324,26 @@ namespace daw::text_data {
 			return result;
 		}
 
-		static constexpr void trim_left( daw::basic_string_view<CharT> &rng ) {
-			auto pos = rng.find_first_of_if( []( CharT c ) {
-				return c == newline_char or not daw::parser::is_unicode_whitespace( c );
+		/***
+		 * Skip whitespace other than the delimiter, e.g. a tab, and newline
+		 */
+		constexpr void trim_left( daw::basic_string_view<CharT> &rng ) const {
+			auto pos = rng.find_first_of_if( [&]( CharT c ) {
+				return c == newline_char or c == delimiter_char or
+				       not daw::parser::is_unicode_whitespace( c );
 			} );
+			if( pos == daw::basic_string_view<CharT>::npos ) {
+				pos = rng.size( );
+			}
 			if( pos > 0 ) {
 				rng.remove_prefix( pos );
 			}
 		}
 
-		static constexpr void
-		column_move_to_next( daw::basic_string_view<CharT> &rng ) {
+		constexpr void
+		column_move_to_next( daw::basic_string_view<CharT> &rng ) const {
 			trim_left( rng );
-			daw_text_table_assert( rng.front( ) == delimiter_char or
+			daw_text_table_assert( rng.empty( ) or rng.front( ) == delimiter_char or
 			                         rng.front( ) == newline_char,
 			                       "Expected next column or new row" );
 			if( not( rng.empty( ) or rng.front( ) == newline_char ) ) {
@@ -208,4 +351,19 @@ namespace daw::text_data {
 			}
 		}
 	};
+
+	/***
+	 * A table with one header row followed by the data in the given dialect
+	 */
+	template<typename CharT, typename Dialect>
+	using basic_dialect_table_type =
+	  basic_csv_table_type<CharT, 0, 1, false, true, false, Dialect>;
+
+	/***
+	 * A table without a header row in the given dialect.  Its columns must be
+	 * found by position, e.g. with text_column_at
+	 */
+	template<typename CharT, typename Dialect>
+	using basic_headerless_dialect_table_type =
+	  basic_csv_table_type<CharT, NoHeaderRow, 0, false, true, false, Dialect>;
 } // namespace daw::text_data
@@ -0,0 +1,118 @@
+// The MIT License (MIT)
+//
+// Copyright (c) Darrell Wright
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and / or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <daw/cpp_17.h>
+
+#include <cstddef>
+#include <type_traits>
+
+namespace daw::text_data {
+	/***
+	 * A table dialect known at compile time.  The scanners are specialized on
+	 * the characters.
+	 * @tparam Comment rows starting with this character are skipped, '\0'
+	 * disables comment rows
+	 * @tparam TrimCarriageReturn remove the \r of \r\n row endings from the
+	 * last cell of a row
+	 */
+	template<char Delimiter, char Quote = '"', char Escape = '\\',
+	         char Comment = '\0', bool TrimCarriageReturn = true>
+	struct text_dialect {
+		using i_am_a_static_dialect = void;
+		static constexpr char delimiter = Delimiter;
+		static constexpr char quote = Quote;
+		static constexpr char escape = Escape;
+		static constexpr char comment = Comment;
+		static constexpr bool trim_carriage_return = TrimCarriageReturn;
+	};
+
+	using csv_dialect = text_dialect<','>;
+	using tsv_dialect = text_dialect<'\t'>;
+	using pipe_dialect = text_dialect<'|'>;
+	using semicolon_dialect = text_dialect<';'>;
+
+	/***
+	 * A table dialect chosen at runtime, e.g. from configuration.  The
+	 * members have the same meaning as the parameters of text_dialect
+	 */
+	struct runtime_dialect {
+		char delimiter = ',';
+		char quote = '"';
+		char escape = '\\';
+		char comment = '\0';
+		bool trim_carriage_return = true;
+	};
+
+	namespace text_table_details {
+		template<typename T>
+		using is_static_dialect_test = typename T::i_am_a_static_dialect;
+
+		template<typename T>
+		inline constexpr bool is_static_dialect_v =
+		  daw::is_detected_v<is_static_dialect_test, T>;
+
+		template<typename T>
+		inline constexpr bool is_dialect_v =
+		  is_static_dialect_v<T> or std::is_same_v<T, runtime_dialect>;
+
+		/***
+		 * The dialect characters of a table type.  They are constants for a
+		 * static dialect and members otherwise, both are accessed as members of
+		 * the table type
+		 */
+		template<typename CharT, typename Dialect,
+		         bool IsStatic = is_static_dialect_v<Dialect>>
+		struct dialect_chars {
+			static constexpr CharT delimiter_char =
+			  static_cast<CharT>( Dialect::delimiter );
+			static constexpr CharT quote_char = static_cast<CharT>( Dialect::quote );
+			static constexpr CharT escape_char =
+			  static_cast<CharT>( Dialect::escape );
+			static constexpr CharT comment_char =
+			  static_cast<CharT>( Dialect::comment );
+			static constexpr bool trim_carriage_return =
+			  Dialect::trim_carriage_return;
+
+			constexpr dialect_chars( ) = default;
+			explicit constexpr dialect_chars( Dialect ) {}
+		};
+
+		template<typename CharT, typename Dialect>
+		struct dialect_chars<CharT, Dialect, false> {
+			CharT delimiter_char = static_cast<CharT>( ',' );
+			CharT quote_char = static_cast<CharT>( '"' );
+			CharT escape_char = static_cast<CharT>( '\\' );
+			CharT comment_char = static_cast<CharT>( '\0' );
+			bool trim_carriage_return = true;
+
+			constexpr dialect_chars( ) = default;
+			explicit constexpr dialect_chars( Dialect const &dialect )
+			  : delimiter_char( static_cast<CharT>( dialect.delimiter ) )
+			  , quote_char( static_cast<CharT>( dialect.quote ) )
+			  , escape_char( static_cast<CharT>( dialect.escape ) )
+			  , comment_char( static_cast<CharT>( dialect.comment ) )
+			  , trim_carriage_return( dialect.trim_carriage_return ) {}
+		};
+	} // namespace text_table_details
+} // namespace daw::text_data
@@ -0,0 +1,270 @@
+// The MIT License (MIT)
+//
+// Copyright (c) Darrell Wright
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and / or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include "daw_text_table_assert.h"
+
+#include <daw/daw_string_view.h>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+
+namespace daw::text_data {
+	/***
+	 * How header cells are compared to the names of the columns
+	 * Exact - byte for byte
+	 * CaseInsensitive - ASCII letters match regardless of case
+	 * Trimmed - blanks around the header cell are ignored
+	 * TrimmedCaseInsensitive - both
+	 */
+	enum class header_match : std::uint8_t {
+		Exact,
+		CaseInsensitive,
+		Trimmed,
+		TrimmedCaseInsensitive
+	};
+
+	namespace text_table_details {
+		inline constexpr std::size_t no_header_index =
+		  std::numeric_limits<std::size_t>::max( );
+
+		template<header_match Match>
+		inline constexpr bool is_case_insensitive_match_v =
+		  Match == header_match::CaseInsensitive or
+		  Match == header_match::TrimmedCaseInsensitive;
+
+		template<header_match Match>
+		inline constexpr bool is_trimmed_match_v =
+		  Match == header_match::Trimmed or
+		  Match == header_match::TrimmedCaseInsensitive;
+
+		template<header_match Match, typename CharT>
+		[[nodiscard]] constexpr std::uint64_t fold_header_char( CharT c ) {
+			auto result = static_cast<std::uint64_t>(
+			  static_cast<std::make_unsigned_t<CharT>>( c ) );
+			if constexpr( is_case_insensitive_match_v<Match> ) {
+				if( result >= 'A' and result <= 'Z' ) {
+					result |= 0x20U;
+				}
+			}
+			return result;
+		}
+
+		/***
+		 * FNV-1a of the folded characters.  This is the only pass over a header
+		 * cell, the slot is derived from it
+		 */
+		template<header_match Match, typename CharT>
+		[[nodiscard]] constexpr std::uint64_t
+		hash_header_name( daw::basic_string_view<CharT> name ) {
+			std::uint64_t result = 0xCBF2'9CE4'8422'2325ULL;
+			for( auto c : name ) {
+				result = ( result ^ fold_header_char<Match>( c ) ) *
+				         0x0000'0100'0000'01B3ULL;
+			}
+			return result;
+		}
+
+		[[nodiscard]] constexpr std::uint64_t
+		mix_header_hash( std::uint64_t hash, std::uint64_t seed ) {
+			hash ^= seed * 0x9E37'79B9'7F4A'7C15ULL;
+			hash ^= hash >> 32U;
+			hash *= 0xD6E8'FEB8'6659'FD93ULL;
+			hash ^= hash >> 32U;
+			return hash;
+		}
+
+		template<header_match Match, typename CharT, typename CharU>
+		[[nodiscard]] constexpr bool
+		header_name_equal( daw::basic_string_view<CharT> lhs,
+		                   daw::basic_string_view<CharU> rhs ) {
+			if( lhs.size( ) != rhs.size( ) ) {
+				return false;
+			}
+			for( std::size_t n = 0; n < lhs.size( ); ++n ) {
+				if( fold_header_char<Match>( lhs[n] ) !=
+				    fold_header_char<Match>( rhs[n] ) ) {
+					return false;
+				}
+			}
+			return true;
+		}
+
+		template<typename CharT>
+		[[nodiscard]] constexpr daw::basic_string_view<CharT>
+		trim_header_name( daw::basic_string_view<CharT> name ) {
+			auto is_blank = []( CharT c ) {
+				return c == static_cast<CharT>( ' ' ) or
+				       c == static_cast<CharT>( '\t' ) or
+				       c == static_cast<CharT>( '\r' );
+			};
+			while( not name.empty( ) and is_blank( name.front( ) ) ) {
+				name.remove_prefix( );
+			}
+			while( not name.empty( ) and is_blank( name.back( ) ) ) {
+				name.remove_suffix( 1 );
+			}
+			return name;
+		}
+
+		/***
+		 * A perfect hash of the column names built at compile time using hash
+		 * and displace.  Names are put in buckets, and each bucket, largest
+		 * first, searches for a seed that moves all of its names to free slots.
+		 * A lookup is one hash of the header cell and one comparison
+		 * @tparam N number of columns, including those not found by name
+		 */
+		template<header_match Match, std::size_t N>
+		class header_hash_table {
+			static constexpr std::size_t bucket_count = N == 0 ? 1 : N;
+			static constexpr std::size_t slot_count = [] {
+				std::size_t result = 1;
+				while( result < 2U * N ) {
+					result *= 2U;
+				}
+				return result;
+			}( );
+			static constexpr std::uint64_t max_seed = 1U << 16U;
+
+			std::array<daw::string_view, N> m_names{};
+			std::array<std::uint64_t, bucket_count> m_seeds{};
+			std::array<std::size_t, slot_count> m_slots{};
+
+			[[nodiscard]] static constexpr std::size_t
+			bucket_of( std::uint64_t hash ) {
+				return static_cast<std::size_t>( mix_header_hash( hash, 0 ) %
+				                                 bucket_count );
+			}
+
+			[[nodiscard]] static constexpr std::size_t
+			slot_of( std::uint64_t hash, std::uint64_t seed ) {
+				return static_cast<std::size_t>( mix_header_hash( hash, seed ) &
+				                                 ( slot_count - 1U ) );
+			}
+
+			/***
+			 * Find a seed that puts every name of the bucket in a free slot
+			 */
+			constexpr void place_bucket( std::size_t bucket,
+			                             std::array<std::uint64_t, N> const &hashes,
+			                             std::size_t const *first,
+			                             std::size_t size ) {
+				auto const last = first + size;
+				std::uint64_t seed = 1;
+				for( ; seed < max_seed; ++seed ) {
+					auto pos = first;
+					for( ; pos != last; ++pos ) {
+						auto &slot = m_slots[slot_of( hashes[*pos], seed )];
+						if( slot != no_header_index ) {
+							break;
+						}
+						slot = *pos;
+					}
+					if( pos == last ) {
+						m_seeds[bucket] = seed;
+						return;
+					}
+					// Undo the names of this bucket that were placed
+					for( ; pos != first; --pos ) {
+						m_slots[slot_of( hashes[pos[-1]], seed )] = no_header_index;
+					}
+				}
+				daw_text_table_error( "Unable to build header hash" );
+			}
+
+		public:
+			/***
+			 * @param names the name of each column
+			 * @param by_name whether the column is found by its name
+			 */
+			constexpr header_hash_table(
+			  std::array<daw::string_view, N> const &names,
+			  std::array<bool, N> const &by_name )
+			  : m_names( names ) {
+				for( auto &slot : m_slots ) {
+					slot = no_header_index;
+				}
+				auto hashes = std::array<std::uint64_t, N>{};
+				auto bucket_starts = std::array<std::size_t, bucket_count + 1U>{};
+				for( std::size_t n = 0; n < N; ++n ) {
+					if( by_name[n] ) {
+						hashes[n] = hash_header_name<Match>( names[n] );
+						++bucket_starts[bucket_of( hashes[n] ) + 1U];
+						for( std::size_t m = 0; m < n; ++m ) {
+							daw_text_table_assert(
+							  not by_name[m] or hashes[m] != hashes[n] or
+							    not header_name_equal<Match>( names[n], names[m] ),
+							  "Duplicate column name" );
+						}
+					}
+				}
+				std::size_t max_bucket_size = 0;
+				for( std::size_t b = 0; b < bucket_count; ++b ) {
+					if( bucket_starts[b + 1U] > max_bucket_size ) {
+						max_bucket_size = bucket_starts[b + 1U];
+					}
+					bucket_starts[b + 1U] += bucket_starts[b];
+				}
+				// The names grouped by bucket
+				auto members = std::array<std::size_t, N>{};
+				auto fill = bucket_starts;
+				for( std::size_t n = 0; n < N; ++n ) {
+					if( by_name[n] ) {
+						members[fill[bucket_of( hashes[n] )]++] = n;
+					}
+				}
+				// Place the buckets with the most names first while the table is
+				// emptiest
+				for( auto size = max_bucket_size; size > 0; --size ) {
+					for( std::size_t b = 0; b < bucket_count; ++b ) {
+						if( bucket_starts[b + 1U] - bucket_starts[b] == size ) {
+							place_bucket( b, hashes, members.data( ) + bucket_starts[b],
+							              size );
+						}
+					}
+				}
+			}
+
+			/***
+			 * @return the index of the column named name or no_header_index
+			 */
+			template<typename CharT>
+			[[nodiscard]] constexpr std::size_t
+			find( daw::basic_string_view<CharT> name ) const {
+				if constexpr( is_trimmed_match_v<Match> ) {
+					name = trim_header_name( name );
+				}
+				auto const hash = hash_header_name<Match>( name );
+				auto const idx = m_slots[slot_of( hash, m_seeds[bucket_of( hash )] )];
+				if( idx == no_header_index or
+				    not header_name_equal<Match>( m_names[idx], name ) ) {
+					return no_header_index;
+				}
+				return idx;
+			}
+		};
+	} // namespace text_table_details
+} // namespace daw::text_data
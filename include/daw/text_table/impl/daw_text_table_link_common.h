@@ -23,6 +23,7 @@
 #pragma once
 
 #include "daw_text_table_assert.h"
+#include "daw_text_table_header_hash.h"
 #include "daw_text_table_link_table_state.h"
 
 #include <daw/cpp_17.h>
@@ -30,10 +31,12 @@
 #include <daw/daw_string_view.h>
 #include <daw/daw_utility.h>
 
+#include <array>
 #include <cstddef>
 #include <cstdint>
 #include <cstdlib>
 #include <cwchar>
+#include <tuple>
 #include <type_traits>
 #include <utility>
 
@@ -144,6 +147,22 @@ namespace daw::text_data {
 		CheckForNarrowing = true
 	};
 
+	/***
+	 * Layout of the cells in a text_timestamp column.  All are UTC
+	 * Iso8601 - YYYY-MM-DD[THH:MM:SS[.fffffffff][Z|+HH:MM|-HH:MM]]
+	 * YmdHms - YYYY-MM-DD[ HH:MM:SS[.fffffffff]]
+	 * Date - YYYY-MM-DD
+	 * EpochSeconds - integer seconds since 1970-01-01T00:00:00Z
+	 * EpochMilliseconds - integer milliseconds since 1970-01-01T00:00:00Z
+	 */
+	enum class timestamp_format : std::uint8_t {
+		Iso8601,
+		YmdHms,
+		Date,
+		EpochSeconds,
+		EpochMilliseconds
+	};
+
 	namespace text_table_details {
 		/***
 		 * Attempt to parse/serialize a type that has not yet been mapped
@@ -192,6 +211,18 @@ namespace daw::text_data {
 		inline constexpr bool has_insert_end_v =
 		  daw::is_detected_v<detect_insert_end, Container, Value>;
 
+		template<typename Container>
+		using detect_splice = decltype( std::declval<Container &>( ).splice(
+		  std::declval<Container &&>( ) ) );
+
+		/***
+		 * Containers that own more than their elements, such as an arena_vector,
+		 * are merged with splice
+		 */
+		template<typename Container>
+		inline constexpr bool has_splice_v =
+		  daw::is_detected_v<detect_splice, Container>;
+
 		template<typename Container>
 		struct basic_appender {
 			Container *m_container;
@@ -247,15 +278,52 @@ namespace daw::text_data {
 		inline constexpr bool is_text_table_parser_v =
 		  daw::is_detected_v<is_text_table_parser_test, T>;
 
+		template<typename TextTableColumn>
+		using is_ignored_column_test =
+		  typename TextTableColumn::column_type::i_am_an_ignored_parser_type;
+
+		/***
+		 * Ignored columns are not read and are not passed to the constructor
+		 */
+		template<typename TextTableColumn>
+		inline constexpr bool is_ignored_column_v =
+		  daw::is_detected_v<is_ignored_column_test, TextTableColumn>;
+
+		inline constexpr std::size_t no_column_index =
+		  std::numeric_limits<std::size_t>::max( );
+
+		template<typename TextTableColumn>
+		using column_index_test = decltype( TextTableColumn::column_index );
+
+		/***
+		 * Positional columns have their index in the row fixed at compile time
+		 * and are not looked up in the header
+		 */
+		template<typename TextTableColumn>
+		inline constexpr bool is_positional_column_v =
+		  daw::is_detected_v<column_index_test, TextTableColumn>;
+
+		template<typename TextTableColumn>
+		constexpr std::size_t column_index_of( ) {
+			if constexpr( is_positional_column_v<TextTableColumn> ) {
+				return TextTableColumn::column_index;
+			} else {
+				return no_column_index;
+			}
+		}
+
 		template<typename CharT>
 		struct location_info_t {
 			daw::basic_string_view<CharT> name;
 			daw::basic_string_view<CharT> location{};
-			bool found = false;
-			size_t column = std::numeric_limits<std::size_t>::max( );
-
-			constexpr location_info_t( daw::string_view n )
-			  : name( n ) {}
+			size_t column = no_column_index;
+			// The cell in location has escapes to remove
+			bool escaped = false;
+
+			constexpr location_info_t( daw::string_view n,
+			                           std::size_t col = no_column_index )
+			  : name( n )
+			  , column( col ) {}
 		};
 
 		template<typename, typename T>
@@ -263,10 +331,50 @@ namespace daw::text_data {
 			return val;
 		}
 
+		/***
+		 * Two positional columns cannot have the same index
+		 */
+		template<typename... TextTableColumns>
+		constexpr bool has_unique_column_indices( ) {
+			constexpr std::size_t count = sizeof...( TextTableColumns );
+			std::array<std::size_t, count> const indices = {
+			  column_index_of<TextTableColumns>( )...};
+			for( std::size_t n = 0; n < count; ++n ) {
+				for( std::size_t m = n + 1U; m < count; ++m ) {
+					if( indices[n] != no_column_index and indices[n] == indices[m] ) {
+						return false;
+					}
+				}
+			}
+			return true;
+		}
+
 		template<typename CharT, typename... TextTableColumns>
 		struct locations_info_t {
+			static_assert( has_unique_column_indices<TextTableColumns...>( ),
+			               "Duplicate column index" );
+			static constexpr std::array<bool, sizeof...( TextTableColumns )>
+			  ignored = {is_ignored_column_v<TextTableColumns>...};
+			static constexpr std::size_t mapped_count =
+			  ( std::size_t{0} + ... +
+			    static_cast<std::size_t>(
+			      not is_ignored_column_v<TextTableColumns> ) );
+			// The mapped columns that are found by their name in the header
+			static constexpr std::array<bool, sizeof...( TextTableColumns )>
+			  by_name = {( not is_ignored_column_v<TextTableColumns> and
+			               not is_positional_column_v<TextTableColumns> )...};
+			static constexpr std::size_t named_count =
+			  ( std::size_t{0} + ... +
+			    static_cast<std::size_t>(
+			      not is_ignored_column_v<TextTableColumns> and
+			      not is_positional_column_v<TextTableColumns> ) );
+			static constexpr bool is_positional = named_count == 0;
+
 			std::array<location_info_t<CharT>, sizeof...( TextTableColumns )>
 			  locations;
+			// The indices of the mapped locations ordered by their column in the
+			// table
+			std::array<std::size_t, mapped_count> visit_order{};
 
 			constexpr location_info_t<CharT> &operator[]( std::size_t idx ) {
 				return locations[idx];
@@ -276,49 +384,105 @@ namespace daw::text_data {
 			operator[]( std::size_t idx ) const {
 				return locations[idx];
 			}
+		};
 
-			constexpr std::optional<std::size_t>
-			find_name( daw::basic_string_view<CharT> name ) const {
-				auto pos = std::find_if( locations.begin( ), locations.end( ),
-				                         [name]( location_info_t<CharT> const &item ) {
-					                         return name == item.name;
-				                         } );
-				if( pos == locations.end( ) ) {
-					return {};
+		/***
+		 * The index of the column with the given name in the contract, or
+		 * no_column_index when there is none
+		 */
+		template<typename... TextTableColumns>
+		constexpr std::size_t find_column_index( daw::string_view name ) {
+			constexpr std::size_t count = sizeof...( TextTableColumns );
+			std::array<daw::string_view, count> const names = {
+			  daw::string_view( TextTableColumns::name )...};
+			for( std::size_t n = 0; n < count; ++n ) {
+				if( names[n] == name ) {
+					return n;
 				}
-				return static_cast<std::size_t>(
-				  std::distance( locations.begin( ), pos ) );
 			}
+			return no_column_index;
+		}
 
-			constexpr std::optional<std::size_t> find_col( std::size_t idx ) const {
-				auto pos = std::find_if( locations.begin( ), locations.end( ),
-				                         [idx]( location_info_t<CharT> const &item ) {
-					                         return idx == item.column;
-				                         } );
-				if( pos == locations.end( ) ) {
-					return {};
-				}
-				return static_cast<std::size_t>(
-				  std::distance( locations.begin( ), pos ) );
-			}
-		};
+		/***
+		 * Finds the column named by a header cell with a single hash
+		 */
+		template<header_match Match, typename... TextTableColumns>
+		inline constexpr auto header_hash =
+		  header_hash_table<Match, sizeof...( TextTableColumns )>(
+		    {daw::string_view( TextTableColumns::name )...},
+		    locations_info_t<char, TextTableColumns...>::by_name );
 
 		template<typename CharT, typename... TextTableColumns>
 		inline constexpr locations_info_t<CharT, TextTableColumns...>
-		  locations_info = {location_info_t<CharT>( TextTableColumns::name )...};
+		  locations_info = {location_info_t<CharT>(
+		    TextTableColumns::name, column_index_of<TextTableColumns>( ) )...};
 
 		template<typename TextTableColumn>
 		using column_name_type = decltype( TextTableColumn::name );
 
 		template<typename TextTableColumn>
 		inline constexpr bool column_requires_header =
-		  daw::is_detected_v<column_name_type, TextTableColumn>;
+		  daw::is_detected_v<column_name_type, TextTableColumn> and
+		  not is_ignored_column_v<TextTableColumn> and
+		  not is_positional_column_v<TextTableColumn>;
 
 		template<typename... TextTableColumns>
 		inline constexpr bool columns_require_header =
 		  ( column_requires_header<TextTableColumns> or ... );
 
-		template<typename... TextTableColumns, typename TableType>
+		/***
+		 * Sort the mapped columns by their position in the row so that a row
+		 * can be read in a single pass
+		 */
+		template<typename CharT, typename... TextTableColumns>
+		constexpr void build_visit_order(
+		  locations_info_t<CharT, TextTableColumns...> &loc_info ) {
+			auto &order = loc_info.visit_order;
+			std::size_t count = 0;
+			for( std::size_t n = 0; n < loc_info.locations.size( ); ++n ) {
+				if( loc_info.ignored[n] ) {
+					continue;
+				}
+				auto const column = loc_info[n].column;
+				auto pos = count++;
+				for( ; pos > 0 and loc_info[order[pos - 1]].column > column; --pos ) {
+					order[pos] = order[pos - 1];
+				}
+				order[pos] = n;
+			}
+		}
+
+		template<std::size_t N>
+		struct positional_plan_t {
+			// The mapped locations in row order and the number of cells to skip
+			// before each of them
+			std::array<std::size_t, N> order{};
+			std::array<std::size_t, N> skips{};
+		};
+
+		/***
+		 * The row layout of a column list where every mapped column is
+		 * positional, computed once at compile time
+		 */
+		template<typename CharT, typename... TextTableColumns>
+		inline constexpr auto positional_plan = [] {
+			auto info = locations_info<CharT, TextTableColumns...>;
+			build_visit_order( info );
+			auto result = positional_plan_t<decltype( info )::mapped_count>{};
+			std::size_t col = 0;
+			for( std::size_t n = 0; n < result.order.size( ); ++n ) {
+				auto const idx = info.visit_order[n];
+				daw_text_table_assert( info[idx].column >= col,
+				                       "Duplicate column index" );
+				result.order[n] = idx;
+				result.skips[n] = info[idx].column - col;
+				col = info[idx].column + 1U;
+			}
+			return result;
+		}( );
+
+		template<header_match Match, typename... TextTableColumns,
+		         typename TableType>
 		[[maybe_unused,
 		  nodiscard]] constexpr locations_info_t<typename TableType::CharT,
 		                                         TextTableColumns...>
@@ -326,57 +490,166 @@ namespace daw::text_data {
 			static_assert( TableType::has_header or
 			                 not columns_require_header<TextTableColumns...>,
 			               "A valid header row is required for named columns" );
+			using location_t =
+			  locations_info_t<typename TableType::CharT, TextTableColumns...>;
 			auto known_locations =
 			  locations_info<typename TableType::CharT, TextTableColumns...>;
 			state.row_move_to_header( );
-			if constexpr( sizeof...( TextTableColumns ) > 0 ) {
+			if constexpr( location_t::named_count > 0 ) {
 				daw_text_table_assert( not state.at_eol( ), "Expected column headers" );
 				std::size_t col = 0;
 				std::size_t found_count = 0;
-				while( found_count < sizeof...( TextTableColumns ) and
+				while( found_count < location_t::named_count and
 				       not state.at_eol( ) ) {
-					auto name = state.column_get_next( );
-					if( auto pos = known_locations.find_name( name ); pos ) {
-						known_locations.locations[*pos].column = col;
+					auto const pos = header_hash<Match, TextTableColumns...>.find(
+					  state.column_get_next( ) );
+					// A repeated header cell maps to its first column
+					if( pos != no_header_index and
+					    known_locations[pos].column == no_column_index ) {
+						known_locations[pos].column = col;
 						++found_count;
 					}
 					++col;
 				}
-				daw_text_table_assert( found_count == sizeof...( TextTableColumns ),
+				daw_text_table_assert( found_count == location_t::named_count,
 				                       "Could not find all mapped columns" );
 			}
+			build_visit_order( known_locations );
 			state.row_move_to_data( );
 			return known_locations;
 		}
 
-		template<std::size_t N, typename TableType, typename... TextTableColumns>
-		constexpr auto
-		find_cell( TableState<TableType> &state,
-		           locations_info_t<typename TableType::CharT, TextTableColumns...>
-		             &loc_info ) {
-			if( loc_info[N].found ) {
-				return loc_info[N].location;
-			}
+		template<typename TableType>
+		constexpr void
+		read_cell( TableState<TableType> &state,
+		           location_info_t<typename TableType::CharT> &location ) {
+			location.location = state.column_get_next( );
+			location.escaped = state.cell_escaped( );
+		}
+
+		/***
+		 * Store the cells of the mapped columns in their locations.  The row is
+		 * read in column order, the cells between mapped columns are skipped
+		 * without being read and reading stops after the last mapped column.
+		 * When all columns are positional the order and skips are constants
+		 */
+		template<typename TableType, typename... TextTableColumns,
+		         std::size_t... Is>
+		constexpr void read_positional_cells(
+		  TableState<TableType> &state,
+		  locations_info_t<typename TableType::CharT, TextTableColumns...>
+		    &loc_info,
+		  std::index_sequence<Is...> ) {
+			constexpr auto const &plan =
+			  positional_plan<typename TableType::CharT, TextTableColumns...>;
+			( ( state.column_skip( plan.skips[Is] ),
+			    read_cell( state, loc_info[plan.order[Is]] ) ),
+			  ... );
+		}
 
-			auto result = state.column_get_next( );
-			while( state.col( ) < loc_info.locations[N].column ) {
-				if( auto const cell_idx = loc_info.find_col( state.col( ) );
-				    cell_idx ) {
-					loc_info[*cell_idx].location = result;
-					loc_info[*cell_idx].found = true;
+		template<typename TableType, typename... TextTableColumns>
+		constexpr void
+		read_row_cells( TableState<TableType> &state,
+		                locations_info_t<typename TableType::CharT,
+		                                 TextTableColumns...> &loc_info ) {
+			using location_t =
+			  locations_info_t<typename TableType::CharT, TextTableColumns...>;
+			if constexpr( location_t::is_positional ) {
+				read_positional_cells(
+				  state, loc_info,
+				  std::make_index_sequence<location_t::mapped_count>{} );
+			} else {
+				std::size_t col = 0;
+				std::size_t previous = 0;
+				for( auto const idx : loc_info.visit_order ) {
+					auto &location = loc_info[idx];
+					if( location.column < col ) {
+						// A named column found in the cell of a positional column
+						location.location = loc_info[previous].location;
+						location.escaped = loc_info[previous].escaped;
+						continue;
+					}
+					state.column_skip( location.column - col );
+					read_cell( state, location );
+					col = location.column + 1U;
+					previous = idx;
 				}
-				result = state.column_get_next( );
 			}
-			return result;
 		}
 
+		template<typename ParserType>
+		using unescaping_parser_test =
+		  typename ParserType::i_am_an_unescaping_parser_type;
+
+		/***
+		 * Parsers that remove the escapes of a cell are passed whether the cell
+		 * has any and the table, which has the quote and escape characters
+		 */
+		template<typename TextTableColumn>
+		inline constexpr bool is_unescaping_column_v =
+		  daw::is_detected_v<unescaping_parser_test,
+		                     typename TextTableColumn::column_type>;
+
 		template<typename TextTableColumn, std::size_t N, typename LocationInfo,
 		         typename TableType>
 		constexpr typename TextTableColumn::parse_to
-		parse_cell( TableState<TableType> &state, LocationInfo &loc_info ) {
+		parse_cell( LocationInfo const &loc_info, TableType const &table ) {
 			using parse_tag = typename TextTableColumn::column_type;
-			return parse_tag::template parse_value<TextTableColumn, TableType>(
-			  find_cell<N, TableType>( state, loc_info ) );
+			if constexpr( is_unescaping_column_v<TextTableColumn> ) {
+				return parse_tag::template parse_value<TextTableColumn>(
+				  loc_info[N].location, loc_info[N].escaped, table );
+			} else {
+				(void)table;
+				return parse_tag::template parse_value<TextTableColumn, TableType>(
+				  loc_info[N].location );
+			}
+		}
+
+		/***
+		 * The parsed cell as a single element tuple, or an empty tuple for
+		 * ignored columns
+		 */
+		template<typename TextTableColumn, std::size_t N, typename LocationInfo,
+		         typename TableType>
+		constexpr auto parse_cell_tuple( LocationInfo const &loc_info,
+		                                 TableType const &table ) {
+			if constexpr( is_ignored_column_v<TextTableColumn> ) {
+				(void)table;
+				return std::tuple<>{};
+			} else {
+				return std::tuple<typename TextTableColumn::parse_to>(
+				  parse_cell<TextTableColumn, N, LocationInfo, TableType>( loc_info,
+				                                                           table ) );
+			}
+		}
+
+		/***
+		 * Construct a T from the cells that have been read into loc_info
+		 */
+		template<typename T, typename... TextTableColumns, std::size_t... Is,
+		         typename TableType>
+		constexpr T
+		construct_row( locations_info_t<typename TableType::CharT,
+		                                TextTableColumns...> const &loc_info,
+		               TableType const &table, std::index_sequence<Is...> ) {
+			using location_t = daw::remove_cvref_t<decltype( loc_info )>;
+			if constexpr( location_t::mapped_count ==
+			              sizeof...( TextTableColumns ) ) {
+				using tp_t = std::tuple<decltype(
+				  parse_cell<TextTableColumns, Is, location_t, TableType>(
+				    loc_info, table ) )...>;
+				// TODO use OnExit to get guaranteed copy elision
+				return std::apply(
+				  daw::construct_a_t<T>{},
+				  tp_t{parse_cell<TextTableColumns, Is, location_t, TableType>(
+				    loc_info, table )...} );
+			} else {
+				return std::apply(
+				  daw::construct_a_t<T>{},
+				  std::tuple_cat(
+				    parse_cell_tuple<TextTableColumns, Is, location_t, TableType>(
+				      loc_info, table )... ) );
+			}
 		}
 
 		template<typename T, typename... TextTableColumns, std::size_t... Is,
@@ -385,17 +658,11 @@ namespace daw::text_data {
 		parse_table_row( TableState<TableType> &state,
 		                 locations_info_t<typename TableType::CharT,
 		                                  TextTableColumns...> &loc_info,
-		                 std::index_sequence<Is...> ) {
+		                 std::index_sequence<Is...> seq ) {
 
-			for( auto &item : loc_info.locations ) {
-				item.found = false;
-			}
-			using tp_t = std::tuple<decltype(
-			  parse_cell<TextTableColumns, Is>( state, loc_info ) )...>;
-			// TODO use OnExit to get guaranteed copy elision
-			auto result = std::apply(
-			  daw::construct_a_t<T>{},
-			  tp_t{parse_cell<TextTableColumns, Is>( state, loc_info )...} );
+			read_row_cells( state, loc_info );
+			auto result =
+			  construct_row<T, TextTableColumns...>( loc_info, state.table( ), seq );
 			state.row_move_to_next( );
 			return result;
 		}
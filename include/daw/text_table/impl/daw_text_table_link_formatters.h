@@ -0,0 +1,336 @@
+// The MIT License (MIT)
+//
+// Copyright (c) Darrell Wright
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and / or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include "daw_text_table_assert.h"
+#include "daw_text_table_link_common.h"
+#include "daw_text_table_link_parser_helpers.h"
+#include "daw_text_table_link_parsers.h"
+#include "daw_text_table_structural.h"
+
+#include <daw/daw_parser_helper_sv.h>
+
+#include <charconv>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <ratio>
+#include <string_view>
+#include <type_traits>
+
+namespace daw::text_data::text_table_details {
+	/***
+	 * A growable character buffer that is written to in place.  It is cleared
+	 * and reused for each batch of rows so that its storage is only
+	 * allocated once
+	 */
+	class text_write_buffer {
+		std::unique_ptr<char[]> m_data;
+		std::size_t m_capacity;
+		std::size_t m_size = 0;
+
+		void grow( std::size_t count ) {
+			auto capacity = m_capacity * 2U;
+			while( capacity < m_size + count ) {
+				capacity *= 2U;
+			}
+			auto data = std::make_unique<char[]>( capacity );
+			std::memcpy( data.get( ), m_data.get( ), m_size );
+			m_data = std::move( data );
+			m_capacity = capacity;
+		}
+
+	public:
+		explicit text_write_buffer( std::size_t capacity )
+		  : m_data( std::make_unique<char[]>( capacity ) )
+		  , m_capacity( capacity ) {
+			daw_text_table_assert( capacity > 0, "Expected a non-empty buffer" );
+		}
+
+		/***
+		 * Room for at least count characters after the end of the data.  They
+		 * become part of the data with commit
+		 */
+		[[nodiscard]] char *prepare( std::size_t count ) {
+			if( m_size + count > m_capacity ) {
+				grow( count );
+			}
+			return m_data.get( ) + m_size;
+		}
+
+		void commit( std::size_t count ) {
+			m_size += count;
+		}
+
+		void append( char c ) {
+			*prepare( 1U ) = c;
+			++m_size;
+		}
+
+		void append( std::string_view str ) {
+			std::memcpy( prepare( str.size( ) ), str.data( ), str.size( ) );
+			m_size += str.size( );
+		}
+
+		[[nodiscard]] std::string_view view( ) const {
+			return std::string_view( m_data.get( ), m_size );
+		}
+
+		[[nodiscard]] std::size_t size( ) const {
+			return m_size;
+		}
+
+		[[nodiscard]] std::size_t capacity( ) const {
+			return m_capacity;
+		}
+
+		void clear( ) {
+			m_size = 0;
+		}
+	};
+
+	/***
+	 * Does a cell have to be quoted to be read back as is.  That is when it
+	 * contains a delimiter, quote, newline or carriage return, or an
+	 * escape_char when allow_escaped
+	 */
+	[[nodiscard]] inline bool needs_quotes( std::string_view cell,
+	                                        char delimiter_char, char quote_char,
+	                                        char escape_char,
+	                                        bool allow_escaped ) {
+		bool result = false;
+		// Short cells are cheaper to check than to copy into a padded block
+		if( structural::is_enabled_for<char> and
+		    cell.size( ) >= structural::block_size ) {
+			structural::for_each_block(
+			  cell.data( ), cell.data( ) + cell.size( ),
+			  [&]( structural::simd_block const &blk, std::size_t len,
+			       std::size_t ) {
+				  auto specials = blk.eq( delimiter_char ) | blk.eq( quote_char ) |
+				                  blk.eq( '\n' ) | blk.eq( '\r' );
+				  if( allow_escaped ) {
+					  specials |= blk.eq( escape_char );
+				  }
+				  result = ( specials & structural::valid_mask( len ) ) != 0;
+				  return result;
+			  } );
+		} else {
+			for( auto c : cell ) {
+				if( c == delimiter_char or c == quote_char or c == '\n' or
+				    c == '\r' or ( allow_escaped and c == escape_char ) ) {
+					return true;
+				}
+			}
+		}
+		return result;
+	}
+
+	/***
+	 * Append a string cell, quoting it only when needed.  A quote_char in the
+	 * cell is doubled and, when allow_escaped, an escape_char is escaped.
+	 * Cells that the reader would see differently unquoted are quoted too, a
+	 * first cell that starts with the comment_char and, when leading
+	 * whitespace is skipped, a cell that starts with whitespace
+	 * @param is_row_start the cell is the first of its row
+	 */
+	template<typename TableType>
+	void write_string_cell( std::string_view cell, text_write_buffer &out,
+	                        TableType const &table, bool is_row_start ) {
+		char const quote_char = table.quote_char;
+		char const escape_char = table.escape_char;
+		bool const starts_comment = is_row_start and table.has_comment_rows( ) and
+		                            not cell.empty( ) and
+		                            cell.front( ) == table.comment_char;
+		bool const starts_blank =
+		  TableType::skip_leading_whitespace and not cell.empty( ) and
+		  daw::parser::is_unicode_whitespace( cell.front( ) );
+		if( not starts_comment and not starts_blank and
+		    not needs_quotes( cell, table.delimiter_char, quote_char, escape_char,
+		                      TableType::allow_escaped ) ) {
+			out.append( cell );
+			return;
+		}
+		// Every character escaped and the two quotes is the most it can take
+		auto const first = out.prepare( cell.size( ) * 2U + 2U );
+		auto ptr = first;
+		*ptr++ = quote_char;
+		for( auto c : cell ) {
+			if( c == quote_char ) {
+				*ptr++ = quote_char;
+			} else if( TableType::allow_escaped and c == escape_char ) {
+				*ptr++ = escape_char;
+			}
+			*ptr++ = c;
+		}
+		*ptr++ = quote_char;
+		out.commit( static_cast<std::size_t>( ptr - first ) );
+	}
+
+	/***
+	 * The shortest text that reads back as the same value
+	 */
+	template<typename Number>
+	void write_number_cell( Number value, text_write_buffer &out ) {
+		// Enough for any integer and for the shortest form of a double
+		constexpr std::size_t max_length = 32;
+		auto const first = out.prepare( max_length );
+		if constexpr( std::is_floating_point_v<Number> ) {
+#if defined( __cpp_lib_to_chars ) and __cpp_lib_to_chars >= 201611L
+			auto const result = std::to_chars( first, first + max_length, value );
+			out.commit( static_cast<std::size_t>( result.ptr - first ) );
+#else
+			auto const len = std::snprintf(
+			  first, max_length, "%.*g",
+			  std::numeric_limits<Number>::max_digits10,
+			  static_cast<double>( value ) );
+			out.commit( static_cast<std::size_t>( len ) );
+#endif
+		} else {
+			auto const result = std::to_chars( first, first + max_length, value );
+			out.commit( static_cast<std::size_t>( result.ptr - first ) );
+		}
+	}
+
+	/***
+	 * Number of fractional digits needed to show every tick of a duration
+	 */
+	template<typename Period>
+	constexpr std::size_t fraction_digits( ) {
+		std::size_t result = 0;
+		for( std::intmax_t den = Period::den; den > 1; den = ( den + 9 ) / 10 ) {
+			++result;
+		}
+		return result;
+	}
+
+	constexpr std::intmax_t power_of_ten( std::size_t exponent ) {
+		std::intmax_t result = 1;
+		for( ; exponent > 0; --exponent ) {
+			result *= 10;
+		}
+		return result;
+	}
+
+	inline char *write_digits( char *ptr, std::uint64_t value,
+	                           std::size_t count ) {
+		for( auto n = count; n > 0; --n ) {
+			ptr[n - 1U] = static_cast<char>( '0' + value % 10U );
+			value /= 10U;
+		}
+		return ptr + count;
+	}
+
+	/***
+	 * Append a time_point as format, the inverse of parse_date_time and
+	 * parse_epoch_time.  Dates are in UTC and the fraction of a second has a
+	 * digit for each tick of the duration
+	 */
+	template<timestamp_format Format, typename Clock, typename Duration>
+	void write_timestamp_cell( std::chrono::time_point<Clock, Duration> value,
+	                           text_write_buffer &out ) {
+		using namespace std::chrono;
+		if constexpr( Format == timestamp_format::EpochSeconds ) {
+			write_number_cell(
+			  floor<seconds>( value.time_since_epoch( ) ).count( ), out );
+		} else if constexpr( Format == timestamp_format::EpochMilliseconds ) {
+			write_number_cell(
+			  floor<milliseconds>( value.time_since_epoch( ) ).count( ), out );
+		} else {
+			using days_t = duration<std::int64_t, std::ratio<86400>>;
+			auto const since_epoch = value.time_since_epoch( );
+			auto const days = floor<days_t>( since_epoch );
+			auto const date = civil_from_days( days.count( ) );
+			daw_text_table_assert( date.year >= 0 and date.year <= 9999,
+			                       "Year out of range" );
+			// YYYY-MM-DDTHH:MM:SS.fffffffffZ
+			auto const first = out.prepare( 32U + fraction_digits<
+			                                         typename Duration::period>( ) );
+			auto ptr = write_digits( first, static_cast<std::uint64_t>( date.year ),
+			                         4U );
+			*ptr++ = '-';
+			ptr = write_digits( ptr, date.month, 2U );
+			*ptr++ = '-';
+			ptr = write_digits( ptr, date.day, 2U );
+			if constexpr( Format != timestamp_format::Date ) {
+				auto const time_of_day = since_epoch - days;
+				auto const secs = floor<seconds>( time_of_day );
+				auto const secs_count = static_cast<std::uint64_t>( secs.count( ) );
+				*ptr++ = Format == timestamp_format::Iso8601 ? 'T' : ' ';
+				ptr = write_digits( ptr, secs_count / 3600U, 2U );
+				*ptr++ = ':';
+				ptr = write_digits( ptr, secs_count / 60U % 60U, 2U );
+				*ptr++ = ':';
+				ptr = write_digits( ptr, secs_count % 60U, 2U );
+				constexpr auto digits =
+				  fraction_digits<typename Duration::period>( );
+				if constexpr( digits > 0 ) {
+					using fraction_t =
+					  duration<std::int64_t, std::ratio<1, power_of_ten( digits )>>;
+					*ptr++ = '.';
+					ptr = write_digits(
+					  ptr,
+					  static_cast<std::uint64_t>(
+					    duration_cast<fraction_t>( time_of_day - secs ).count( ) ),
+					  digits );
+				}
+				if constexpr( Format == timestamp_format::Iso8601 ) {
+					*ptr++ = 'Z';
+				}
+			}
+			out.commit( static_cast<std::size_t>( ptr - first ) );
+		}
+	}
+
+	/***
+	 * Append the cell of a column.  This is the inverse of the parser of the
+	 * column_type
+	 * @param is_row_start the cell is the first of its row
+	 */
+	template<typename TextTableColumn, typename TableType, typename Value>
+	void write_cell( Value const &value, text_write_buffer &out,
+	                 TableType const &table, bool is_row_start ) {
+		using column_type = typename TextTableColumn::column_type;
+		if constexpr( std::is_same_v<column_type, TextTableParserTypes::Custom> ) {
+			write_string_cell(
+			  std::string_view( typename TextTableColumn::to_converter{}( value ) ),
+			  out, table, is_row_start );
+		} else if constexpr( std::is_same_v<column_type,
+		                                    TextTableParserTypes::Date> ) {
+			write_timestamp_cell<TextTableColumn::format>( value, out );
+		} else if constexpr( std::disjunction_v<
+		                       std::is_same<column_type,
+		                                    TextTableParserTypes::Real>,
+		                       std::is_same<column_type,
+		                                    TextTableParserTypes::Signed>,
+		                       std::is_same<column_type,
+		                                    TextTableParserTypes::Unsigned>> ) {
+			write_number_cell( value, out );
+		} else {
+			write_string_cell( std::string_view( value ), out, table, is_row_start );
+		}
+	}
+} // namespace daw::text_data::text_table_details
@@ -20,12 +20,29 @@
 // OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
 // SOFTWARE.
 
+
 #pragma once
 
+#include "daw_text_table_power_of_five.h"
+#include "daw_text_table_structural.h"
+
+#include <charconv>
+#include <cstdint>
 #include <cstdlib>
+#include <cstring>
 #include <cwchar>
+#include <limits>
+#include <locale>
+#include <sstream>
+#include <string>
 #include <type_traits>
 
+#if defined( DAW_TEXT_TABLE_HAS_IS_CONSTANT_EVALUATED ) and                    \
+  not defined( DAW_TEXT_TABLE_NO_SIMD ) and defined( __SSSE3__ )
+#include <tmmintrin.h>
+#define DAW_TEXT_TABLE_USE_SSSE3
+#endif
+
 namespace daw::text_data::text_table_details {
 	template<typename Real>
 	auto str_to_real( char const *first, char **last ) {
@@ -60,4 +77,772 @@ namespace daw::text_data::text_table_details {
 			               "Unknown floating point type" );
 		}
 	}
+
+	struct uint128_parts {
+		std::uint64_t low;
+		std::uint64_t high;
+	};
+
+#if defined( __SIZEOF_INT128__ )
+	__extension__ using uint128_t = unsigned __int128;
+#endif
+
+	[[nodiscard]] constexpr uint128_parts full_multiplication( std::uint64_t a,
+	                                                           std::uint64_t b ) {
+#if defined( __SIZEOF_INT128__ )
+		auto const r = static_cast<uint128_t>( a ) * b;
+		return {static_cast<std::uint64_t>( r ),
+		        static_cast<std::uint64_t>( r >> 64U )};
+#else
+		auto const a_lo = a & 0xFFFF'FFFFULL;
+		auto const a_hi = a >> 32U;
+		auto const b_lo = b & 0xFFFF'FFFFULL;
+		auto const b_hi = b >> 32U;
+		auto const lo_lo = a_lo * b_lo;
+		auto const hi_lo = a_hi * b_lo;
+		auto const lo_hi = a_lo * b_hi;
+		auto const hi_hi = a_hi * b_hi;
+		auto const cross = ( lo_lo >> 32U ) + ( hi_lo & 0xFFFF'FFFFULL ) + lo_hi;
+		return {( cross << 32U ) | ( lo_lo & 0xFFFF'FFFFULL ),
+		        hi_hi + ( hi_lo >> 32U ) + ( cross >> 32U )};
+#endif
+	}
+
+	/***
+	 * @pre value != 0
+	 */
+	[[nodiscard]] constexpr int count_leading_zeros( std::uint64_t value ) {
+#if defined( __GNUC__ ) or defined( __clang__ )
+		return __builtin_clzll( value );
+#else
+		int result = 0;
+		for( std::uint64_t mask = 1ULL << 63U; ( value & mask ) == 0;
+		     mask >>= 1U ) {
+			++result;
+		}
+		return result;
+#endif
+	}
+
+	template<typename Real>
+	struct binary_format;
+
+	template<>
+	struct binary_format<double> {
+		using bits_t = std::uint64_t;
+		static constexpr int mantissa_explicit_bits = 52;
+		static constexpr int minimum_exponent = -1023;
+		static constexpr int infinite_power = 0x7FF;
+		static constexpr int sign_index = 63;
+		static constexpr int smallest_power_of_ten = -342;
+		static constexpr int largest_power_of_ten = 308;
+		static constexpr int min_exponent_round_to_even = -4;
+		static constexpr int max_exponent_round_to_even = 23;
+	};
+
+	template<>
+	struct binary_format<float> {
+		using bits_t = std::uint32_t;
+		static constexpr int mantissa_explicit_bits = 23;
+		static constexpr int minimum_exponent = -127;
+		static constexpr int infinite_power = 0xFF;
+		static constexpr int sign_index = 31;
+		static constexpr int smallest_power_of_ten = -65;
+		static constexpr int largest_power_of_ten = 38;
+		static constexpr int min_exponent_round_to_even = -17;
+		static constexpr int max_exponent_round_to_even = 10;
+	};
+
+	/***
+	 * A binary floating point value as its biased exponent and explicit
+	 * mantissa bits
+	 */
+	struct adjusted_mantissa {
+		std::uint64_t mantissa = 0;
+		int power2 = 0;
+
+		constexpr bool operator==( adjusted_mantissa const &rhs ) const {
+			return mantissa == rhs.mantissa and power2 == rhs.power2;
+		}
+
+		constexpr bool operator!=( adjusted_mantissa const &rhs ) const {
+			return not operator==( rhs );
+		}
+	};
+
+	/***
+	 * Eisel-Lemire.  Compute the correctly rounded binary value of w * 10^q
+	 * @pre w has at most 19 significant decimal digits
+	 */
+	template<typename Real>
+	[[nodiscard]] constexpr adjusted_mantissa compute_float( std::int64_t q,
+	                                                         std::uint64_t w ) {
+		using binary = binary_format<Real>;
+		constexpr int mantissa_bits = binary::mantissa_explicit_bits;
+		if( w == 0 or q < binary::smallest_power_of_ten ) {
+			return {0, 0};
+		}
+		if( q > binary::largest_power_of_ten ) {
+			return {0, binary::infinite_power};
+		}
+		int const lz = count_leading_zeros( w );
+		w <<= static_cast<unsigned>( lz );
+
+		auto const index =
+		  2U * static_cast<std::size_t>( q - smallest_power_of_five );
+		auto product = full_multiplication( w, power_of_five_128[index] );
+		constexpr std::uint64_t precision_mask =
+		  0xFFFF'FFFF'FFFF'FFFFULL >> static_cast<unsigned>( mantissa_bits + 3 );
+		if( ( product.high & precision_mask ) == precision_mask ) {
+			auto const low_product =
+			  full_multiplication( w, power_of_five_128[index + 1U] );
+			product.low += low_product.high;
+			if( low_product.high > product.low ) {
+				++product.high;
+			}
+		}
+
+		int const upperbit = static_cast<int>( product.high >> 63U );
+		auto const shift =
+		  static_cast<unsigned>( upperbit + 64 - mantissa_bits - 3 );
+		auto answer = adjusted_mantissa{};
+		answer.mantissa = product.high >> shift;
+		// floor( log2( 10^q ) ) + 63
+		auto const power = static_cast<int>(
+		  ( ( ( 152170 + 65536 ) * q ) >> 16 ) + 63 );
+		answer.power2 = power + upperbit - lz - binary::minimum_exponent;
+		if( answer.power2 <= 0 ) {
+			// Subnormal
+			if( -answer.power2 + 1 >= 64 ) {
+				return {0, 0};
+			}
+			answer.mantissa >>= static_cast<unsigned>( -answer.power2 + 1 );
+			answer.mantissa += answer.mantissa & 1U;
+			answer.mantissa >>= 1U;
+			answer.power2 =
+			  answer.mantissa < ( std::uint64_t{1} << mantissa_bits ) ? 0 : 1;
+			return answer;
+		}
+		// Exactly halfway between two values, round to even
+		if( product.low <= 1U and q >= binary::min_exponent_round_to_even and
+		    q <= binary::max_exponent_round_to_even and
+		    ( answer.mantissa & 3U ) == 1U and
+		    ( answer.mantissa << shift ) == product.high ) {
+			answer.mantissa &= ~std::uint64_t{1};
+		}
+		answer.mantissa += answer.mantissa & 1U;
+		answer.mantissa >>= 1U;
+		if( answer.mantissa >= ( std::uint64_t{2} << mantissa_bits ) ) {
+			answer.mantissa = std::uint64_t{1} << mantissa_bits;
+			++answer.power2;
+		}
+		answer.mantissa &= ~( std::uint64_t{1} << mantissa_bits );
+		if( answer.power2 >= binary::infinite_power ) {
+			return {0, binary::infinite_power};
+		}
+		return answer;
+	}
+
+	template<typename Real>
+	[[nodiscard]] constexpr Real to_real( adjusted_mantissa am, bool negative ) {
+		using binary = binary_format<Real>;
+		if( not is_constant_evaluated( ) ) {
+			auto bits = static_cast<typename binary::bits_t>(
+			  am.mantissa |
+			  ( static_cast<std::uint64_t>( am.power2 )
+			    << static_cast<unsigned>( binary::mantissa_explicit_bits ) ) |
+			  ( static_cast<std::uint64_t>( negative )
+			    << static_cast<unsigned>( binary::sign_index ) ) );
+			Real result{};
+			std::memcpy( &result, &bits, sizeof( Real ) );
+			return result;
+		}
+		if( am.power2 == binary::infinite_power ) {
+			return negative ? -std::numeric_limits<Real>::infinity( )
+			                : std::numeric_limits<Real>::infinity( );
+		}
+		// mantissa * 2^exp, scaled by powers of two so every step is exact
+		auto mantissa = am.mantissa;
+		int exp = -binary::minimum_exponent + binary::mantissa_explicit_bits;
+		if( am.power2 == 0 ) {
+			exp = 1 - exp;
+		} else {
+			mantissa |= std::uint64_t{1} << binary::mantissa_explicit_bits;
+			exp = am.power2 - exp;
+		}
+		auto result = static_cast<Real>( mantissa );
+		for( ; exp >= 32; exp -= 32 ) {
+			result *= static_cast<Real>( 0x1p32 );
+		}
+		for( ; exp <= -32; exp += 32 ) {
+			result *= static_cast<Real>( 0x1p-32 );
+		}
+		if( exp > 0 ) {
+			result *= static_cast<Real>( std::uint64_t{1} << exp );
+		} else if( exp < 0 ) {
+			result /= static_cast<Real>( std::uint64_t{1} << -exp );
+		}
+		return negative ? -result : result;
+	}
+
+	template<typename CharT>
+	[[nodiscard]] constexpr bool is_digit( CharT c ) {
+		return static_cast<unsigned>( c ) - static_cast<unsigned>( '0' ) < 10U;
+	}
+
+	template<typename CharT>
+	[[nodiscard]] constexpr std::uint64_t to_digit( CharT c ) {
+		return static_cast<std::uint64_t>( static_cast<unsigned>( c ) -
+		                                   static_cast<unsigned>( '0' ) );
+	}
+
+	template<typename CharT>
+	[[nodiscard]] constexpr bool
+	starts_with_nocase( CharT const *first, CharT const *last,
+	                    char const *lower_case_prefix ) {
+		for( ; *lower_case_prefix != '\0'; ++first, ++lower_case_prefix ) {
+			if( first == last or
+			    ( static_cast<unsigned>( *first ) | 0x20U ) !=
+			      static_cast<unsigned>( *lower_case_prefix ) ) {
+				return false;
+			}
+		}
+		return true;
+	}
+
+	template<typename CharT>
+	[[nodiscard]] constexpr CharT const *skip_blanks( CharT const *first,
+	                                                  CharT const *last ) {
+		while( first != last and ( *first == ' ' or *first == '\t' ) ) {
+			++first;
+		}
+		return first;
+	}
+
+	/***
+	 * Load 8 single byte characters as a little endian integer.  Compilers
+	 * turn this into a single load
+	 */
+	template<typename CharT>
+	[[nodiscard]] constexpr std::uint64_t load_eight_chars( CharT const *ptr ) {
+		static_assert( sizeof( CharT ) == 1 );
+		std::uint64_t result = 0;
+		for( unsigned n = 0; n < 8U; ++n ) {
+			result |= static_cast<std::uint64_t>( static_cast<unsigned char>( ptr[n] ) )
+			          << ( 8U * n );
+		}
+		return result;
+	}
+
+	[[nodiscard]] constexpr bool is_eight_digits( std::uint64_t chars ) {
+		return ( ( chars & 0xF0F0'F0F0'F0F0'F0F0ULL ) |
+		         ( ( ( chars + 0x0606'0606'0606'0606ULL ) &
+		             0xF0F0'F0F0'F0F0'F0F0ULL ) >>
+		           4U ) ) == 0x3333'3333'3333'3333ULL;
+	}
+
+	/***
+	 * Value of 8 digit characters loaded with load_eight_chars
+	 * @pre is_eight_digits( chars )
+	 */
+	[[nodiscard]] constexpr std::uint64_t
+	parse_eight_digits( std::uint64_t chars ) {
+		constexpr std::uint64_t mask = 0x0000'00FF'0000'00FFULL;
+		constexpr std::uint64_t mul1 = 100ULL + ( 1000000ULL << 32U );
+		constexpr std::uint64_t mul2 = 1ULL + ( 10000ULL << 32U );
+		chars -= 0x3030'3030'3030'3030ULL;
+		chars = ( chars * 10U ) + ( chars >> 8U );
+		return ( ( ( chars & mask ) * mul1 ) +
+		         ( ( ( chars >> 16U ) & mask ) * mul2 ) ) >>
+		       32U;
+	}
+
+#if defined( DAW_TEXT_TABLE_USE_SSSE3 )
+	/***
+	 * Parse 16 digits at once
+	 * @return false if any of the 16 characters is not a digit
+	 */
+	[[nodiscard]] inline bool parse_sixteen_digits( char const *ptr,
+	                                                std::uint64_t &value ) {
+		auto const digits = _mm_sub_epi8(
+		  _mm_loadu_si128( reinterpret_cast<__m128i const *>( ptr ) ),
+		  _mm_set1_epi8( '0' ) );
+		auto const nine = _mm_set1_epi8( 9 );
+		if( _mm_movemask_epi8( _mm_cmpeq_epi8( _mm_max_epu8( digits, nine ),
+		                                       nine ) ) != 0xFFFF ) {
+			return false;
+		}
+		// 8 x 2 digits, 4 x 4 digits, then 2 x 8 digits
+		auto const pairs = _mm_maddubs_epi16(
+		  digits, _mm_setr_epi8( 10, 1, 10, 1, 10, 1, 10, 1, 10, 1, 10, 1, 10, 1,
+		                         10, 1 ) );
+		auto const quads = _mm_madd_epi16(
+		  pairs, _mm_setr_epi16( 100, 1, 100, 1, 100, 1, 100, 1 ) );
+		auto const packed = _mm_packs_epi32( quads, quads );
+		auto const octs = _mm_madd_epi16(
+		  packed, _mm_setr_epi16( 10000, 1, 10000, 1, 10000, 1, 10000, 1 ) );
+		auto const hi = static_cast<std::uint32_t>( _mm_cvtsi128_si32( octs ) );
+		auto const lo = static_cast<std::uint32_t>(
+		  _mm_cvtsi128_si32( _mm_srli_si128( octs, 4 ) ) );
+		value = static_cast<std::uint64_t>( hi ) * 100000000ULL + lo;
+		return true;
+	}
+#endif
+
+	template<typename CharT>
+	struct unsigned_parse_result {
+		std::uint64_t value = 0;
+		// One past the last digit.  Equal to the input start if there are none
+		CharT const *last = nullptr;
+		bool overflow = false;
+	};
+
+	/***
+	 * Parse the run of decimal digits at the start of [first, last).  Blocks
+	 * of 16 and 8 digits are converted at once, the first 19 digits cannot
+	 * overflow and after that each digit is checked.
+	 */
+	template<typename CharT>
+	[[nodiscard]] constexpr unsigned_parse_result<CharT>
+	parse_unsigned_digits( CharT const *first, CharT const *last ) {
+		constexpr std::size_t max_safe_digits = 19;
+		std::uint64_t result = 0;
+		auto ptr = first;
+		auto digit_count = [&] { return static_cast<std::size_t>( ptr - first ); };
+		if constexpr( sizeof( CharT ) == 1 ) {
+#if defined( DAW_TEXT_TABLE_USE_SSSE3 )
+			if( not is_constant_evaluated( ) and last - ptr >= 16 ) {
+				if( parse_sixteen_digits( reinterpret_cast<char const *>( ptr ),
+				                          result ) ) {
+					ptr += 16;
+				}
+			}
+#endif
+			while( last - ptr >= 8 and digit_count( ) + 8U <= max_safe_digits ) {
+				auto const chars = load_eight_chars( ptr );
+				if( not is_eight_digits( chars ) ) {
+					break;
+				}
+				result = result * 100000000ULL + parse_eight_digits( chars );
+				ptr += 8;
+			}
+		}
+		for( ; ptr != last and is_digit( *ptr ); ++ptr ) {
+			auto const dig = to_digit( *ptr );
+			if( digit_count( ) >= max_safe_digits and
+			    result > ( std::numeric_limits<std::uint64_t>::max( ) - dig ) / 10U ) {
+				return {0, ptr, true};
+			}
+			result = result * 10U + dig;
+		}
+		return {result, ptr, false};
+	}
+
+	template<typename Real, typename CharT>
+	struct real_parse_result {
+		Real value{};
+		// One past the last character used.  Equal to the input start on error
+		CharT const *last = nullptr;
+	};
+
+	/***
+	 * Parse the number in [first, last) using charconv, or a stream in the
+	 * classic locale where charconv cannot parse Real.  Used when the decimal
+	 * has more significant digits than fit the fast path
+	 */
+	template<typename Real, typename CharT>
+	[[nodiscard]] Real parse_real_fallback( CharT const *first,
+	                                        CharT const *last ) {
+		// The number has been validated, all characters are ASCII
+		auto buff = std::string( static_cast<std::size_t>( last - first ), '\0' );
+		for( std::size_t n = 0; first != last; ++first, ++n ) {
+			buff[n] = static_cast<char>( *first );
+		}
+#if defined( __cpp_lib_to_chars )
+		if constexpr( not std::is_same_v<Real, long double> ) {
+			auto result = Real{};
+			auto const *num_first = buff.data( );
+			bool const negative = *num_first == '-';
+			if( negative or *num_first == '+' ) {
+				++num_first;
+			}
+			(void)std::from_chars( num_first, buff.data( ) + buff.size( ), result );
+			return negative ? -result : result;
+		}
+#endif
+		// strtod and friends use the decimal point of the global C locale
+		auto in = std::istringstream( buff );
+		in.imbue( std::locale::classic( ) );
+		auto result = Real{};
+		in >> result;
+		return result;
+	}
+
+	/***
+	 * Parse a decimal floating point number from [first, last) without reading
+	 * outside of the range.  Leading spaces are skipped and parsing stops at
+	 * the first character that cannot be part of the number.  It is locale
+	 * independent and correctly rounded for float and double.
+	 */
+	template<typename Real, typename CharT>
+	[[nodiscard]] constexpr real_parse_result<Real, CharT>
+	parse_real( CharT const *first, CharT const *last ) {
+		static_assert( std::is_floating_point_v<Real> );
+		auto const error = real_parse_result<Real, CharT>{Real{}, first};
+		auto ptr = first;
+		while( ptr != last and ( *ptr == ' ' or *ptr == '\t' ) ) {
+			++ptr;
+		}
+		auto const num_first = ptr;
+		bool const negative = ptr != last and *ptr == '-';
+		if( ptr != last and ( *ptr == '-' or *ptr == '+' ) ) {
+			++ptr;
+		}
+		if( ptr != last and not is_digit( *ptr ) and *ptr != '.' ) {
+			if( starts_with_nocase( ptr, last, "nan" ) ) {
+				auto const nan = std::numeric_limits<Real>::quiet_NaN( );
+				return {negative ? -nan : nan, ptr + 3};
+			}
+			if( starts_with_nocase( ptr, last, "inf" ) ) {
+				auto const inf = std::numeric_limits<Real>::infinity( );
+				auto const end = starts_with_nocase( ptr, last, "infinity" ) ? ptr + 8
+				                                                             : ptr + 3;
+				return {negative ? -inf : inf, end};
+			}
+			return error;
+		}
+
+		std::uint64_t w = 0;
+		std::int64_t exp10 = 0;
+		int significant_digits = 0;
+		bool truncated = false;
+		bool has_digits = false;
+		for( ; ptr != last and is_digit( *ptr ); ++ptr ) {
+			has_digits = true;
+			auto const dig = to_digit( *ptr );
+			if( significant_digits == 0 and dig == 0 ) {
+				continue;
+			}
+			if( significant_digits < 19 ) {
+				w = w * 10U + dig;
+				++significant_digits;
+			} else {
+				++exp10;
+				truncated = truncated or dig != 0;
+			}
+		}
+		if( ptr != last and *ptr == '.' ) {
+			++ptr;
+			for( ; ptr != last and is_digit( *ptr ); ++ptr ) {
+				has_digits = true;
+				auto const dig = to_digit( *ptr );
+				if( significant_digits == 0 and dig == 0 ) {
+					--exp10;
+					continue;
+				}
+				if( significant_digits < 19 ) {
+					w = w * 10U + dig;
+					++significant_digits;
+					--exp10;
+				} else {
+					truncated = truncated or dig != 0;
+				}
+			}
+		}
+		if( not has_digits ) {
+			return error;
+		}
+		if( ptr != last and ( *ptr == 'e' or *ptr == 'E' ) ) {
+			auto exp_ptr = ptr + 1;
+			bool const exp_negative = exp_ptr != last and *exp_ptr == '-';
+			if( exp_ptr != last and ( *exp_ptr == '-' or *exp_ptr == '+' ) ) {
+				++exp_ptr;
+			}
+			if( exp_ptr != last and is_digit( *exp_ptr ) ) {
+				std::int64_t exp_part = 0;
+				for( ; exp_ptr != last and is_digit( *exp_ptr ); ++exp_ptr ) {
+					if( exp_part < 0x1'0000'0000LL ) {
+						exp_part = exp_part * 10 + static_cast<std::int64_t>(
+						                             to_digit( *exp_ptr ) );
+					}
+				}
+				exp10 += exp_negative ? -exp_part : exp_part;
+				ptr = exp_ptr;
+			}
+		}
+
+		if constexpr( std::is_same_v<Real, long double> ) {
+			if( is_constant_evaluated( ) ) {
+				auto const am = compute_float<double>( exp10, w );
+				return {static_cast<Real>( to_real<double>( am, negative ) ), ptr};
+			}
+			return {parse_real_fallback<Real>( num_first, ptr ), ptr};
+		} else {
+			auto const am = compute_float<Real>( exp10, w );
+			if( truncated and not is_constant_evaluated( ) and
+			    am != compute_float<Real>( exp10, w + 1U ) ) {
+				// The dropped digits can change the rounding
+				return {parse_real_fallback<Real>( num_first, ptr ), ptr};
+			}
+			return {to_real<Real>( am, negative ), ptr};
+		}
+	}
+
+	/***
+	 * Load 8 characters as a little endian integer of bytes.  Characters that
+	 * are not ASCII fail and leave chars unchanged
+	 */
+	template<typename CharT>
+	[[nodiscard]] constexpr bool load_eight_ascii( CharT const *ptr,
+	                                               std::uint64_t &chars ) {
+		if constexpr( sizeof( CharT ) == 1 ) {
+			chars = load_eight_chars( ptr );
+			return true;
+		} else {
+			std::uint64_t result = 0;
+			for( unsigned n = 0; n < 8U; ++n ) {
+				auto const c = static_cast<std::uint64_t>( ptr[n] );
+				if( c > 0x7FU ) {
+					return false;
+				}
+				result |= c << ( 8U * n );
+			}
+			chars = result;
+			return true;
+		}
+	}
+
+	/***
+	 * Three 2 digit fields separated by sep, e.g. HH:MM:SS or YY-MM-DD, from
+	 * 8 characters loaded with load_eight_ascii.  The fields are checked and
+	 * converted together
+	 * @return false if the characters do not have that layout
+	 */
+	[[nodiscard]] constexpr bool parse_two_digit_fields( std::uint64_t chars,
+	                                                     char sep,
+	                                                     unsigned &first,
+	                                                     unsigned &second,
+	                                                     unsigned &third ) {
+		constexpr std::uint64_t sep_mask = 0x0000'FF00'00FF'0000ULL;
+		constexpr std::uint64_t digit_mask = ~sep_mask;
+		auto const seps = static_cast<std::uint64_t>(
+		                    static_cast<unsigned char>( sep ) ) *
+		                  0x0000'0100'0001'0000ULL;
+		// Put '0' in the separator positions and reuse the 8 digit check
+		auto const digits = ( chars & digit_mask ) | 0x0000'3000'0030'0000ULL;
+		if( ( chars & sep_mask ) != seps or not is_eight_digits( digits ) ) {
+			return false;
+		}
+		auto const values = digits - 0x3030'3030'3030'3030ULL;
+		// Each byte n becomes 10 * byte n + byte n + 1, the fields are the tens
+		auto const pairs = values * 10U + ( values >> 8U );
+		first = static_cast<unsigned>( pairs & 0xFFU );
+		second = static_cast<unsigned>( ( pairs >> 24U ) & 0xFFU );
+		third = static_cast<unsigned>( ( pairs >> 48U ) & 0xFFU );
+		return true;
+	}
+
+	template<typename CharT>
+	[[nodiscard]] constexpr bool parse_two_digits( CharT const *ptr,
+	                                               unsigned &value ) {
+		if( not is_digit( ptr[0] ) or not is_digit( ptr[1] ) ) {
+			return false;
+		}
+		value =
+		  static_cast<unsigned>( to_digit( ptr[0] ) * 10U + to_digit( ptr[1] ) );
+		return true;
+	}
+
+	[[nodiscard]] constexpr bool is_leap_year( std::int64_t year ) {
+		return year % 4 == 0 and ( year % 100 != 0 or year % 400 == 0 );
+	}
+
+	[[nodiscard]] constexpr unsigned days_in_month( std::int64_t year,
+	                                                unsigned month ) {
+		if( month == 2U ) {
+			return is_leap_year( year ) ? 29U : 28U;
+		}
+		// 31 days alternate from March, restarting in August
+		return ( month <= 7U ? month : month - 1U ) % 2U == 1U ? 31U : 30U;
+	}
+
+	/***
+	 * Days since 1970-01-01 of a proleptic Gregorian date
+	 * @see http://howardhinnant.github.io/date_algorithms.html#days_from_civil
+	 */
+	[[nodiscard]] constexpr std::int64_t
+	days_from_civil( std::int64_t year, unsigned month, unsigned day ) {
+		year -= static_cast<std::int64_t>( month <= 2U );
+		auto const era = ( year >= 0 ? year : year - 399 ) / 400;
+		auto const yoe = static_cast<unsigned>( year - era * 400 );
+		auto const doy =
+		  ( 153U * ( month > 2U ? month - 3U : month + 9U ) + 2U ) / 5U + day - 1U;
+		auto const doe = yoe * 365U + yoe / 4U - yoe / 100U + doy;
+		return era * 146097 + static_cast<std::int64_t>( doe ) - 719468;
+	}
+
+	struct civil_date {
+		std::int64_t year;
+		unsigned month;
+		unsigned day;
+	};
+
+	/***
+	 * The proleptic Gregorian date of a number of days since 1970-01-01
+	 * @see http://howardhinnant.github.io/date_algorithms.html#civil_from_days
+	 */
+	[[nodiscard]] constexpr civil_date civil_from_days( std::int64_t days ) {
+		days += 719468;
+		auto const era = ( days >= 0 ? days : days - 146096 ) / 146097;
+		auto const doe = static_cast<unsigned>( days - era * 146097 );
+		auto const yoe = ( doe - doe / 1460U + doe / 36524U - doe / 146096U ) / 365U;
+		auto const doy = doe - ( 365U * yoe + yoe / 4U - yoe / 100U );
+		auto const mp = ( 5U * doy + 2U ) / 153U;
+		auto const month = mp < 10U ? mp + 3U : mp - 9U;
+		return civil_date{static_cast<std::int64_t>( yoe ) + era * 400 +
+		                    static_cast<std::int64_t>( month <= 2U ),
+		                  month, doy - ( 153U * mp + 2U ) / 5U + 1U};
+	}
+
+	struct timestamp_parse_result {
+		// Seconds since 1970-01-01T00:00:00Z and the nanoseconds after that
+		std::int64_t seconds = 0;
+		std::uint32_t nanoseconds = 0;
+		bool ok = false;
+	};
+
+	/***
+	 * Parse YYYY-MM-DD, optionally followed by a T or space separated
+	 * HH:MM:SS[.fffffffff] and, if allow_offset, by Z or +HH:MM/-HH:MM.
+	 * Leading and trailing blanks are skipped.  The date and time fields are
+	 * at fixed offsets and are each checked and converted with one load
+	 */
+	template<typename CharT>
+	[[nodiscard]] constexpr timestamp_parse_result
+	parse_date_time( CharT const *first, CharT const *last, bool allow_time,
+	                 bool allow_offset ) {
+		first = skip_blanks( first, last );
+		while( last != first and ( last[-1] == ' ' or last[-1] == '\t' ) ) {
+			--last;
+		}
+		timestamp_parse_result result{};
+		std::uint64_t chars = 0;
+		unsigned century = 0;
+		unsigned year = 0;
+		unsigned month = 0;
+		unsigned day = 0;
+		if( last - first < 10 or not parse_two_digits( first, century ) or
+		    not load_eight_ascii( first + 2, chars ) or
+		    not parse_two_digit_fields( chars, '-', year, month, day ) ) {
+			return result;
+		}
+		auto const full_year = static_cast<std::int64_t>( century * 100U + year );
+		if( month < 1U or month > 12U or day < 1U or
+		    day > days_in_month( full_year, month ) ) {
+			return result;
+		}
+		result.seconds = days_from_civil( full_year, month, day ) * 86400;
+		first += 10;
+		if( first == last ) {
+			result.ok = true;
+			return result;
+		}
+		unsigned hour = 0;
+		unsigned minute = 0;
+		unsigned second = 0;
+		if( not allow_time or last - first < 9 or
+		    not( *first == 'T' or *first == 't' or *first == ' ' ) or
+		    not load_eight_ascii( first + 1, chars ) or
+		    not parse_two_digit_fields( chars, ':', hour, minute, second ) or
+		    hour > 23U or minute > 59U or second > 60U ) {
+			// A second of 60 is a leap second
+			return result;
+		}
+		result.seconds += static_cast<std::int64_t>( hour * 3600U + minute * 60U +
+		                                             second );
+		first += 9;
+		if( first != last and ( *first == '.' or *first == ',' ) ) {
+			++first;
+			auto const digits = first;
+			std::uint32_t scale = 1'000'000'000U;
+			for( ; first != last and is_digit( *first ); ++first ) {
+				// Digits past nanoseconds are truncated
+				if( scale > 1U ) {
+					scale /= 10U;
+					result.nanoseconds +=
+					  static_cast<std::uint32_t>( to_digit( *first ) ) * scale;
+				}
+			}
+			if( first == digits ) {
+				return result;
+			}
+		}
+		if( first != last and allow_offset ) {
+			if( *first == 'Z' or *first == 'z' ) {
+				++first;
+			} else if( *first == '+' or *first == '-' ) {
+				bool const negative = *first == '-';
+				++first;
+				unsigned offset_hour = 0;
+				unsigned offset_minute = 0;
+				if( last - first < 2 or not parse_two_digits( first, offset_hour ) ) {
+					return result;
+				}
+				first += 2;
+				if( first != last and *first == ':' ) {
+					++first;
+				}
+				if( last - first >= 2 and parse_two_digits( first, offset_minute ) ) {
+					first += 2;
+				}
+				if( offset_hour > 23U or offset_minute > 59U ) {
+					return result;
+				}
+				auto const offset = static_cast<std::int64_t>( offset_hour * 3600U +
+				                                               offset_minute * 60U );
+				// Local time is UTC plus the offset
+				result.seconds += negative ? offset : -offset;
+			}
+		}
+		result.ok = first == last;
+		return result;
+	}
+
+	/***
+	 * Parse an integer count of 1 / Divisor seconds since 1970-01-01T00:00:00Z
+	 */
+	template<std::uint32_t Divisor, typename CharT>
+	[[nodiscard]] constexpr timestamp_parse_result
+	parse_epoch_time( CharT const *first, CharT const *last ) {
+		static_assert( Divisor > 0 and 1'000'000'000U % Divisor == 0 );
+		timestamp_parse_result result{};
+		first = skip_blanks( first, last );
+		bool const negative = first != last and *first == '-';
+		if( first != last and ( *first == '-' or *first == '+' ) ) {
+			++first;
+		}
+		auto const digits = parse_unsigned_digits( first, last );
+		if( digits.last == first or digits.overflow or
+		    skip_blanks( digits.last, last ) != last or
+		    digits.value > static_cast<std::uint64_t>(
+		                     std::numeric_limits<std::int64_t>::max( ) ) ) {
+			return result;
+		}
+		auto const value = static_cast<std::int64_t>( digits.value );
+		auto seconds = value / Divisor;
+		auto ticks = value % Divisor;
+		if( negative ) {
+			// Round down so that the sub second part is never negative
+			seconds = -seconds;
+			if( ticks != 0 ) {
+				--seconds;
+				ticks = Divisor - ticks;
+			}
+		}
+		result.seconds = seconds;
+		result.nanoseconds =
+		  static_cast<std::uint32_t>( ticks ) * ( 1'000'000'000U / Divisor );
+		result.ok = true;
+		return result;
+	}
 } // namespace daw::text_data::text_table_details
@@ -25,28 +25,66 @@
 #include "daw_text_table_assert.h"
 #include "daw_text_table_link_common.h"
 #include "daw_text_table_link_parser_helpers.h"
+#include "daw_text_table_string_arena.h"
 
 #include <daw/cpp_17.h>
 #include <daw/daw_parser_helper_sv.h>
 #include <daw/daw_utility.h>
 
+#include <chrono>
 #include <cstddef>
 #include <cstdint>
 #include <cstdlib>
 #include <cwchar>
+#include <limits>
+#include <string>
+#include <string_view>
 #include <type_traits>
 #include <utility>
 
 namespace daw::text_data::text_table_details {
+	/***
+	 * Copy a cell to out without its escapes
+	 * @pre out has room for rng.size( ) characters
+	 * @return number of characters written
+	 */
+	template<typename TableType, typename CharT>
+	std::size_t unescape_cell( daw::basic_string_view<CharT> rng,
+	                           TableType const &table, CharT *out ) {
+		return structural::unescape( rng.data( ), rng.data( ) + rng.size( ),
+		                             table.quote_char, table.escape_char,
+		                             TableType::allow_escaped, out );
+	}
+
 	namespace TextTableParserTypes {
+		/***
+		 * Cells with escapes are unescaped, other cells are copied as is
+		 */
 		struct String {
 			using i_am_a_text_table_parser_type = void;
+			using i_am_an_unescaping_parser_type = void;
 
 			template<typename TextTableColumn, typename TableType, typename CharT>
-			static constexpr typename TextTableColumn::parse_to
-			parse_value( daw::basic_string_view<CharT> rng ) {
-				return
-				  typename TextTableColumn::constructor{}( rng.data( ), rng.size( ) );
+			static typename TextTableColumn::parse_to
+			parse_value( daw::basic_string_view<CharT> rng, bool is_escaped,
+			             TableType const &table ) {
+				using parse_to = typename TextTableColumn::parse_to;
+				using constructor = typename TextTableColumn::constructor;
+				if( not is_escaped ) {
+					return constructor{}( rng.data( ), rng.size( ) );
+				}
+				if constexpr( std::is_same_v<parse_to, std::basic_string<CharT>> and
+				              std::is_same_v<constructor,
+				                             daw::construct_a_t<parse_to>> ) {
+					// Unescape directly into the result
+					auto result = parse_to( rng.size( ), CharT{} );
+					result.resize( unescape_cell( rng, table, result.data( ) ) );
+					return result;
+				} else {
+					auto buff = std::basic_string<CharT>( rng.size( ), CharT{} );
+					auto const sz = unescape_cell( rng, table, buff.data( ) );
+					return constructor{}( buff.data( ), sz );
+				}
 			}
 		};
 
@@ -65,14 +103,14 @@ namespace daw::text_data::text_table_details {
 			using i_am_a_text_table_parser_type = void;
 
 			template<typename TextTableColumn, typename TableType, typename CharT>
-			static typename TextTableColumn::parse_to
+			static constexpr typename TextTableColumn::parse_to
 			parse_value( daw::basic_string_view<CharT> rng ) {
-				CharT *last = const_cast<CharT *>( rng.end( ) );
-				float f = str_to_real<typename TextTableColumn::parse_to>( rng.begin( ),
-				                                                           &last );
-				daw_text_table_assert( last != rng.begin( ), "Error parsing float" );
+				auto const result = parse_real<typename TextTableColumn::parse_to>(
+				  rng.data( ), rng.data( ) + rng.size( ) );
+				daw_text_table_assert( result.last != rng.data( ),
+				                       "Error parsing float" );
 
-				return typename TextTableColumn::constructor{}( f );
+				return typename TextTableColumn::constructor{}( result.value );
 			}
 		};
 
@@ -82,74 +120,195 @@ namespace daw::text_data::text_table_details {
 			template<typename TextTableColumn, typename TableType, typename CharT>
 			static constexpr typename TextTableColumn::parse_to
 			parse_value( daw::basic_string_view<CharT> rng ) {
-				std::uintmax_t result = 0;
-				auto dig = static_cast<unsigned>( rng.pop_front( ) ) -
-				           static_cast<unsigned>( TableType::zero_char );
-				while( dig < 10U ) {
-					result *= 10U;
-					result += dig;
-					dig = static_cast<unsigned>( rng.pop_front( ) ) -
-					      static_cast<unsigned>( TableType::zero_char );
+				using result_t = typename TextTableColumn::parse_to;
+				auto const last = rng.data( ) + rng.size( );
+				auto first = skip_blanks( rng.data( ), last );
+				if( first != last and *first == '+' ) {
+					++first;
 				}
+				auto const result = parse_unsigned_digits( first, last );
+				daw_text_table_assert( result.last != first, "Expected number" );
+				daw_text_table_assert( not result.overflow, "Integer overflow" );
 				if constexpr( TextTableColumn::range_check ==
 				              NumericRangeCheck::CheckForNarrowing ) {
-					return typename TextTableColumn::constructor{}(
-					  daw::narrow_cast<typename TextTableColumn::parse_to>( result ) );
-				} else {
-					return typename TextTableColumn::constructor{}(
-					  static_cast<typename TextTableColumn::parse_to>( result ) );
+					daw_text_table_assert(
+					  result.value <= static_cast<std::uint64_t>(
+					                    std::numeric_limits<result_t>::max( ) ),
+					  "Number out of range" );
 				}
+				return typename TextTableColumn::constructor{}(
+				  static_cast<result_t>( result.value ) );
 			}
 		};
 
 		struct Signed {
 			using i_am_a_text_table_parser_type = void;
+
 			template<typename TextTableColumn, typename TableType, typename CharT>
 			static constexpr typename TextTableColumn::parse_to
 			parse_value( daw::basic_string_view<CharT> rng ) {
-				std::intmax_t result = 0;
-				auto dig = static_cast<unsigned>( rng.pop_front( ) ) -
-				           static_cast<unsigned>( TableType::zero_char );
-				int const sign = [&] {
-					switch( rng.front( ) ) {
-					case '-':
-						rng.remove_prefix( );
-						return -1;
-					case '+':
-						rng.remove_prefix( );
-						break;
-					}
-					return 1;
-				}( );
-				while( dig < 10U ) {
-					result *= 10;
-					result += static_cast<std::intmax_t>( dig );
-					dig = static_cast<unsigned>( rng.pop_front( ) ) -
-					      static_cast<unsigned>( TableType::zero_char );
+				using result_t = typename TextTableColumn::parse_to;
+				auto const last = rng.data( ) + rng.size( );
+				auto first = skip_blanks( rng.data( ), last );
+				bool const negative = first != last and *first == '-';
+				if( first != last and ( *first == '-' or *first == '+' ) ) {
+					++first;
 				}
-				result *= sign;
+				auto const result = parse_unsigned_digits( first, last );
+				daw_text_table_assert( result.last != first, "Expected number" );
+				// The magnitude of the minimum is one more than the maximum
+				auto const max_magnitude =
+				  static_cast<std::uint64_t>(
+				    std::numeric_limits<std::intmax_t>::max( ) ) +
+				  static_cast<std::uint64_t>( negative );
+				daw_text_table_assert(
+				  not result.overflow and result.value <= max_magnitude,
+				  "Integer overflow" );
+				auto const value =
+				  negative ? static_cast<std::intmax_t>( ~result.value + 1U )
+				           : static_cast<std::intmax_t>( result.value );
 				if constexpr( TextTableColumn::range_check ==
 				              NumericRangeCheck::CheckForNarrowing ) {
-					return daw::narrow_cast<typename TextTableColumn::parse_to>( result );
-				} else {
-					return static_cast<typename TextTableColumn::parse_to>( result );
+					daw_text_table_assert(
+					  value >= static_cast<std::intmax_t>(
+					             std::numeric_limits<result_t>::min( ) ) and
+					    value <= static_cast<std::intmax_t>(
+					               std::numeric_limits<result_t>::max( ) ),
+					  "Number out of range" );
 				}
+				return typename TextTableColumn::constructor{}(
+				  static_cast<result_t>( value ) );
 			}
 		};
 
 		struct Date {
 			using i_am_a_text_table_parser_type = void;
+
+			/***
+			 * The cell is parsed as the format of the column to a system_clock
+			 * time_point rounded down to the duration of parse_to.  The
+			 * constructor is called with that time_point
+			 */
+			template<typename TextTableColumn, typename TableType, typename CharT>
+			static constexpr typename TextTableColumn::parse_to
+			parse_value( daw::basic_string_view<CharT> rng ) {
+				using duration_t = typename TextTableColumn::parse_to::duration;
+				auto const first = rng.data( );
+				auto const last = rng.data( ) + rng.size( );
+				auto const result = [&] {
+					switch( TextTableColumn::format ) {
+					case timestamp_format::Iso8601:
+						return parse_date_time( first, last, true, true );
+					case timestamp_format::YmdHms:
+						return parse_date_time( first, last, true, false );
+					case timestamp_format::Date:
+						return parse_date_time( first, last, false, false );
+					case timestamp_format::EpochSeconds:
+						return parse_epoch_time<1U>( first, last );
+					case timestamp_format::EpochMilliseconds:
+						break;
+					}
+					return parse_epoch_time<1000U>( first, last );
+				}( );
+				daw_text_table_assert( result.ok, "Invalid timestamp" );
+				return typename TextTableColumn::constructor{}(
+				  std::chrono::time_point<std::chrono::system_clock, duration_t>(
+				    std::chrono::floor<duration_t>(
+				      std::chrono::seconds( result.seconds ) ) +
+				    std::chrono::floor<duration_t>(
+				      std::chrono::nanoseconds( result.nanoseconds ) ) ) );
+			}
 		};
 
 		struct Custom {
 			using i_am_a_text_table_parser_type = void;
+
+			/***
+			 * The from_converter of the column is called with a view of the cell
+			 */
+			template<typename TextTableColumn, typename TableType, typename CharT>
+			static constexpr typename TextTableColumn::parse_to
+			parse_value( daw::basic_string_view<CharT> rng ) {
+				return typename TextTableColumn::from_converter{}(
+				  std::basic_string_view<CharT>( rng.data( ), rng.size( ) ) );
+			}
 		};
 
+		/***
+		 * The cell is copied to the active string_arena without its escapes
+		 */
+		struct StringArena {
+			using i_am_a_text_table_parser_type = void;
+			using i_am_an_unescaping_parser_type = void;
+
+			template<typename TextTableColumn, typename TableType, typename CharT>
+			static typename TextTableColumn::parse_to
+			parse_value( daw::basic_string_view<CharT> rng, bool is_escaped,
+			             TableType const &table ) {
+				auto arena = active_string_arena<CharT>;
+				daw_text_table_assert(
+				  arena != nullptr,
+				  "text_string_arena columns require an arena_vector container" );
+				auto const cell =
+				  is_escaped
+				    ? arena->store( rng.size( ),
+				                    [&]( CharT *out ) {
+					                    return unescape_cell( rng, table, out );
+				                    } )
+				    : arena->store(
+				        std::basic_string_view<CharT>( rng.data( ), rng.size( ) ) );
+				return typename TextTableColumn::constructor{}( cell.data( ),
+				                                                cell.size( ) );
+			}
+		};
+
+		/***
+		 * A view of the cell in the table data.  Only cells with escapes are
+		 * copied, without their escapes, to the active string_arena
+		 */
+		struct StringView {
+			using i_am_a_text_table_parser_type = void;
+			using i_am_an_unescaping_parser_type = void;
+
+			template<typename TextTableColumn, typename TableType, typename CharT>
+			static typename TextTableColumn::parse_to
+			parse_value( daw::basic_string_view<CharT> rng, bool is_escaped,
+			             TableType const &table ) {
+				if( not is_escaped ) {
+					return
+					  typename TextTableColumn::constructor{}( rng.data( ), rng.size( ) );
+				}
+				auto arena = active_string_arena<CharT>;
+				daw_text_table_assert(
+				  arena != nullptr,
+				  "Escaped text_string_view cells require an arena_vector container" );
+				auto const cell = arena->store( rng.size( ), [&]( CharT *out ) {
+					return unescape_cell( rng, table, out );
+				} );
+				return typename TextTableColumn::constructor{}( cell.data( ),
+				                                                cell.size( ) );
+			}
+		};
+
+		/***
+		 * Cells of ignored columns are skipped without being read
+		 */
 		struct Ignored {
 			using i_am_a_text_table_parser_type = void;
+			using i_am_an_ignored_parser_type = void;
 		};
 	} // namespace TextTableParserTypes
 
+	/***
+	 * Columns that may store their cells in the arena of an arena_vector
+	 */
+	template<typename TextTableColumn>
+	inline constexpr bool is_arena_column_v = std::disjunction_v<
+	  std::is_same<typename TextTableColumn::column_type,
+	               TextTableParserTypes::StringArena>,
+	  std::is_same<typename TextTableColumn::column_type,
+	               TextTableParserTypes::StringView>>;
+
 	template<typename Number>
 	using get_numeric_column_type = std::conditional_t<
 	  std::is_floating_point_v<Number>, TextTableParserTypes::Real,
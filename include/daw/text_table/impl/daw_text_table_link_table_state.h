@@ -22,6 +22,8 @@
 
 #pragma once
 
+#include "daw_text_table_assert.h"
+
 #include <daw/cpp_17.h>
 #include <daw/daw_string_view.h>
 #include <daw/daw_utility.h>
@@ -45,41 +47,81 @@ namespace daw::text_data {
 		  "The TableType has not declared itself to be a valid TableType" );
 
 		using CharT = typename TableType::CharT;
-		static constexpr CharT delimiter_char = TableType::delimiter_char;
-		static constexpr CharT quote_char = TableType::quote_char;
-		static constexpr CharT zero_char = TableType::zero_char;
 		static constexpr CharT newline_char = TableType::newline_char;
-		static constexpr CharT escape_char = TableType::escape_char;
 		static constexpr bool has_header = TableType::has_header;
 
 	private:
 		daw::basic_string_view<CharT> m_state;
+		TableType m_table;
 		std::size_t m_col = 0;
 		std::size_t m_row = 0;
+		bool m_cell_escaped = false;
 
 	public:
-		constexpr TableState( daw::basic_string_view<CharT> table_data )
-		  : m_state( table_data ) {}
+		constexpr TableState( daw::basic_string_view<CharT> table_data,
+		                      TableType const &table = TableType{} )
+		  : m_state( table_data )
+		  , m_table( table ) {
+			m_table.skip_comment_rows( m_state );
+		}
 
 		constexpr void row_move_to_next( ) {
 			m_col = 0;
 			++m_row;
-			TableType::row_move_to_next( m_state );
+			m_table.row_move_to_next( m_state );
+		}
+
+		/***
+		 * Move to a data row using an index of row offsets, such as a
+		 * row_index.  The state starts at the nearest indexed row before it and
+		 * the rows between are skipped
+		 * @param table_data the table the index was built from
+		 * @param row the data row, 0 is the first row after the header
+		 */
+		template<typename RowIndex>
+		constexpr void seek_row( daw::basic_string_view<CharT> table_data,
+		                         RowIndex const &index, std::size_t row ) {
+			daw_text_table_assert( index.key( ).size == table_data.size( ),
+			                       "The row index is for a different table" );
+			auto const pos = index.find( row );
+			m_state = daw::basic_string_view<CharT>(
+			  table_data.data( ) + pos.offset, table_data.size( ) - pos.offset );
+			m_col = 0;
+			m_row = TableType::data_row + pos.row;
+			for( auto n = pos.row; n < row and not at_eof( ); ++n ) {
+				row_move_to_next( );
+			}
 		}
 
 		constexpr void row_move_to_header( ) {
 			m_col = 0;
-			m_row = TableType::row_move_to_header( m_state );
+			m_row = m_table.row_move_to_header( m_state );
 		}
 
 		constexpr void row_move_to_data( ) {
 			m_col = 0;
-			m_row = TableType::row_move_to_data( m_state );
+			m_row = m_table.row_move_to_data( m_state );
 		}
 
 		constexpr daw::basic_string_view<CharT> column_get_next( ) {
 			++m_col;
-			return TableType::column_get_next( m_state );
+			return m_table.column_get_next( m_state, m_cell_escaped );
+		}
+
+		/***
+		 * Does the last cell read have escapes that have to be removed to get
+		 * its value
+		 */
+		constexpr bool cell_escaped( ) const {
+			return m_cell_escaped;
+		}
+
+		/***
+		 * Move past the next count cells without reading them
+		 */
+		constexpr void column_skip( std::size_t count ) {
+			m_col += count;
+			m_table.column_skip( m_state, count );
 		}
 
 		constexpr bool at_eol( ) const {
@@ -94,6 +136,20 @@ namespace daw::text_data {
 			return m_col;
 		}
 
+		/***
+		 * The table type, which holds the dialect
+		 */
+		constexpr TableType const &table( ) const {
+			return m_table;
+		}
+
+		/***
+		 * The unparsed portion of the table
+		 */
+		constexpr daw::basic_string_view<CharT> remaining( ) const {
+			return m_state;
+		}
+
 		constexpr bool operator==( TableState const &rhs ) const {
 			return ( at_eof( ) and rhs.at_eof( ) ) or
 			       m_state.data( ) == rhs.m_state.data( );
@@ -0,0 +1,284 @@
+// The MIT License (MIT)
+//
+// Copyright (c) Darrell Wright
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and / or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include "daw_text_table_assert.h"
+#include "daw_text_table_link_common.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace daw::text_data {
+	/***
+	 * A monotonic buffer for the characters of string cells.  Storage is only
+	 * released when the arena is destroyed.  Blocks do not move, so views
+	 * into an arena stay valid when it is moved
+	 */
+	template<typename CharT>
+	class string_arena {
+		static constexpr std::size_t first_block_size = 4096U;
+		static constexpr std::size_t max_block_size = 1024U * 1024U;
+
+		std::vector<std::unique_ptr<CharT[]>> m_blocks{};
+		CharT *m_position = nullptr;
+		std::size_t m_available = 0;
+		std::size_t m_next_block_size = first_block_size;
+
+		CharT *allocate( std::size_t count ) {
+			if( count > m_available ) {
+				auto const block_size = std::max( count, m_next_block_size );
+				m_blocks.push_back( std::make_unique<CharT[]>( block_size ) );
+				m_position = m_blocks.back( ).get( );
+				m_available = block_size;
+				m_next_block_size = std::min( m_next_block_size * 2U, max_block_size );
+			}
+			auto result = m_position;
+			m_position += count;
+			m_available -= count;
+			return result;
+		}
+
+	public:
+		string_arena( ) = default;
+		string_arena( string_arena const & ) = delete;
+		string_arena &operator=( string_arena const & ) = delete;
+		string_arena( string_arena && ) noexcept = default;
+		string_arena &operator=( string_arena && ) noexcept = default;
+		~string_arena( ) = default;
+
+		/***
+		 * Copy a cell into the arena
+		 */
+		std::basic_string_view<CharT> store( std::basic_string_view<CharT> cell ) {
+			return store( cell.size( ), [&]( CharT *out ) {
+				std::copy( cell.begin( ), cell.end( ), out );
+				return cell.size( );
+			} );
+		}
+
+		/***
+		 * Reserve room for count characters and fill it with write, which
+		 * returns how many it used.  The rest is returned to the arena
+		 */
+		template<typename Write>
+		std::basic_string_view<CharT> store( std::size_t count, Write &&write ) {
+			if( count == 0 ) {
+				return {};
+			}
+			auto const first = allocate( count );
+			std::size_t const used = write( first );
+			m_position -= count - used;
+			m_available += count - used;
+			return std::basic_string_view<CharT>( first, used );
+		}
+
+		/***
+		 * Take ownership of the storage of other.  Views into other stay valid
+		 */
+		void splice( string_arena &&other ) {
+			m_blocks.insert( m_blocks.end( ),
+			                 std::make_move_iterator( other.m_blocks.begin( ) ),
+			                 std::make_move_iterator( other.m_blocks.end( ) ) );
+			other.m_blocks.clear( );
+			other.m_position = nullptr;
+			other.m_available = 0;
+		}
+
+		/***
+		 * Number of heap allocations made for character storage
+		 */
+		[[nodiscard]] std::size_t block_count( ) const {
+			return m_blocks.size( );
+		}
+	};
+
+	namespace text_table_details {
+		/***
+		 * The arena that text_string_arena cells are copied to on this thread.
+		 * It is set while an arena_vector is being appended to
+		 */
+		template<typename CharT>
+		inline thread_local string_arena<CharT> *active_string_arena = nullptr;
+	} // namespace text_table_details
+
+	/***
+	 * A container of rows and the arena holding the characters of their
+	 * text_string_arena columns.  The views in the rows are valid for the
+	 * lifetime of the container, so it can be moved but not copied
+	 * @tparam T type of row with a text_data_contract
+	 */
+	template<typename T, typename CharT = char>
+	class arena_vector {
+		std::vector<T> m_rows{};
+		string_arena<CharT> m_arena{};
+
+	public:
+		using value_type = T;
+		using char_type = CharT;
+		using size_type = std::size_t;
+		using reference = T &;
+		using const_reference = T const &;
+		using iterator = typename std::vector<T>::iterator;
+		using const_iterator = typename std::vector<T>::const_iterator;
+
+		arena_vector( ) = default;
+		arena_vector( arena_vector const & ) = delete;
+		arena_vector &operator=( arena_vector const & ) = delete;
+		arena_vector( arena_vector && ) noexcept = default;
+		arena_vector &operator=( arena_vector && ) noexcept = default;
+		~arena_vector( ) = default;
+
+		void push_back( T &&row ) {
+			m_rows.push_back( std::move( row ) );
+		}
+
+		void reserve( std::size_t rows ) {
+			m_rows.reserve( rows );
+		}
+
+		/***
+		 * Append the rows of other and take ownership of its arena
+		 */
+		void splice( arena_vector &&other ) {
+			m_rows.insert( m_rows.end( ), std::make_move_iterator( other.begin( ) ),
+			               std::make_move_iterator( other.end( ) ) );
+			m_arena.splice( std::move( other.m_arena ) );
+			other.m_rows.clear( );
+		}
+
+		[[nodiscard]] string_arena<CharT> &arena( ) {
+			return m_arena;
+		}
+
+		[[nodiscard]] string_arena<CharT> const &arena( ) const {
+			return m_arena;
+		}
+
+		[[nodiscard]] std::vector<T> const &rows( ) const {
+			return m_rows;
+		}
+
+		[[nodiscard]] T &operator[]( std::size_t idx ) {
+			return m_rows[idx];
+		}
+
+		[[nodiscard]] T const &operator[]( std::size_t idx ) const {
+			return m_rows[idx];
+		}
+
+		[[nodiscard]] std::size_t size( ) const {
+			return m_rows.size( );
+		}
+
+		[[nodiscard]] bool empty( ) const {
+			return m_rows.empty( );
+		}
+
+		[[nodiscard]] iterator begin( ) {
+			return m_rows.begin( );
+		}
+
+		[[nodiscard]] const_iterator begin( ) const {
+			return m_rows.begin( );
+		}
+
+		[[nodiscard]] iterator end( ) {
+			return m_rows.end( );
+		}
+
+		[[nodiscard]] const_iterator end( ) const {
+			return m_rows.end( );
+		}
+	};
+
+	namespace text_table_details {
+		template<typename Container>
+		inline constexpr bool is_arena_vector_v = false;
+
+		template<typename T, typename CharT>
+		inline constexpr bool is_arena_vector_v<arena_vector<T, CharT>> = true;
+
+		/***
+		 * Whether values with arena columns can be stored in Container, or
+		 * anywhere but an arena_vector when there is no Container.  Compilation
+		 * fails when they cannot
+		 */
+		template<bool HasArenaColumns, typename Container = void>
+		constexpr bool check_arena_columns( ) {
+			static_assert( not HasArenaColumns or is_arena_vector_v<Container>,
+			               "text_string_arena and text_string_view columns require "
+			               "parsing into an arena_vector" );
+			return true;
+		}
+
+		template<typename ColumnList, typename Container = void>
+		constexpr bool check_arena_container( ) {
+			return check_arena_columns<ColumnList::has_arena_columns, Container>( );
+		}
+
+		/***
+		 * Makes the arena of the container the active arena for as long as the
+		 * appender exists, which is the whole parse.  Copies of the appender do
+		 * not change the active arena
+		 */
+		template<typename T, typename CharT>
+		class basic_appender<arena_vector<T, CharT>> {
+			arena_vector<T, CharT> *m_container;
+			string_arena<CharT> *m_previous;
+			bool m_is_owner = true;
+
+		public:
+			explicit basic_appender( arena_vector<T, CharT> &container )
+			  : m_container( &container )
+			  , m_previous( std::exchange( active_string_arena<CharT>,
+			                               &container.arena( ) ) ) {}
+
+			basic_appender( basic_appender const &other )
+			  : m_container( other.m_container )
+			  , m_previous( other.m_previous )
+			  , m_is_owner( false ) {}
+
+			basic_appender &operator=( basic_appender const & ) = delete;
+
+			~basic_appender( ) {
+				if( m_is_owner ) {
+					active_string_arena<CharT> = m_previous;
+				}
+			}
+
+			void operator( )( T &&value ) const {
+				m_container->push_back( std::move( value ) );
+			}
+
+			void operator( )( T const &value ) const {
+				m_container->push_back( T( value ) );
+			}
+		};
+	} // namespace text_table_details
+} // namespace daw::text_data
@@ -0,0 +1,507 @@
+// The MIT License (MIT)
+//
+// Copyright (c) Darrell Wright
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and / or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+#if defined( __has_builtin )
+#if __has_builtin( __builtin_is_constant_evaluated )
+#define DAW_TEXT_TABLE_HAS_IS_CONSTANT_EVALUATED
+#endif
+#elif defined( __GNUC__ ) and __GNUC__ >= 9
+#define DAW_TEXT_TABLE_HAS_IS_CONSTANT_EVALUATED
+#elif defined( _MSC_VER ) and _MSC_VER >= 1925
+#define DAW_TEXT_TABLE_HAS_IS_CONSTANT_EVALUATED
+#endif
+
+// The vectorized paths are only used when we can tell that we are not in a
+// constant expression.  Define DAW_TEXT_TABLE_NO_SIMD to force the scalar
+// state machines
+#if defined( DAW_TEXT_TABLE_HAS_IS_CONSTANT_EVALUATED ) and                    \
+  not defined( DAW_TEXT_TABLE_NO_SIMD )
+#if defined( __AVX2__ )
+#include <immintrin.h>
+#define DAW_TEXT_TABLE_USE_AVX2
+#elif defined( __SSE2__ ) or defined( _M_X64 ) or                              \
+  ( defined( _M_IX86_FP ) and _M_IX86_FP >= 2 )
+#include <emmintrin.h>
+#define DAW_TEXT_TABLE_USE_SSE2
+#endif
+#endif
+
+#if defined( _MSC_VER ) and not defined( __clang__ )
+#include <intrin.h>
+#endif
+
+namespace daw::text_data::text_table_details {
+	[[nodiscard]] constexpr bool is_constant_evaluated( ) {
+#if defined( DAW_TEXT_TABLE_HAS_IS_CONSTANT_EVALUATED )
+		return __builtin_is_constant_evaluated( );
+#else
+		return true;
+#endif
+	}
+
+	/***
+	 * Bitmask based scanning of the structural characters(delimiters, quotes
+	 * and newlines) of a table, 64 bytes at a time.  Bit n of a mask is set
+	 * when byte n of the block matches.
+	 */
+	namespace structural {
+		inline constexpr std::size_t block_size = 64;
+
+#if defined( DAW_TEXT_TABLE_USE_AVX2 ) or defined( DAW_TEXT_TABLE_USE_SSE2 )
+		inline constexpr bool has_simd = true;
+#else
+		inline constexpr bool has_simd = false;
+#endif
+
+		/***
+		 * The vectorized scanners work on single byte characters and have no
+		 * notion of a backslash escape
+		 */
+		template<typename CharT>
+		inline constexpr bool is_enabled_for = has_simd and sizeof( CharT ) == 1;
+
+		[[nodiscard]] constexpr std::uint64_t prefix_xor( std::uint64_t m ) {
+			m ^= m << 1U;
+			m ^= m << 2U;
+			m ^= m << 4U;
+			m ^= m << 8U;
+			m ^= m << 16U;
+			m ^= m << 32U;
+			return m;
+		}
+
+		[[nodiscard]] inline std::size_t count_trailing_zeros( std::uint64_t m ) {
+#if defined( _MSC_VER ) and not defined( __clang__ )
+			unsigned long result = 0;
+			_BitScanForward64( &result, m );
+			return static_cast<std::size_t>( result );
+#else
+			return static_cast<std::size_t>( __builtin_ctzll( m ) );
+#endif
+		}
+
+		[[nodiscard]] inline std::size_t popcount( std::uint64_t m ) {
+#if defined( _MSC_VER ) and not defined( __clang__ )
+			return static_cast<std::size_t>( __popcnt64( m ) );
+#else
+			return static_cast<std::size_t>( __builtin_popcountll( m ) );
+#endif
+		}
+
+		/***
+		 * All ones if the last bit of the quoted region mask is set.  Used to
+		 * carry the in quote state into the next block
+		 */
+		[[nodiscard]] constexpr std::uint64_t carry_of( std::uint64_t quoted ) {
+			return ( quoted >> 63U ) != 0 ? ~std::uint64_t{0} : std::uint64_t{0};
+		}
+
+		/***
+		 * A 64 byte block of the table data loaded into vector registers.
+		 */
+		class simd_block {
+#if defined( DAW_TEXT_TABLE_USE_AVX2 )
+			__m256i m_lo;
+			__m256i m_hi;
+
+		public:
+			explicit simd_block( char const *ptr )
+			  : m_lo( _mm256_loadu_si256( reinterpret_cast<__m256i const *>( ptr ) ) )
+			  , m_hi( _mm256_loadu_si256(
+			      reinterpret_cast<__m256i const *>( ptr + 32 ) ) ) {}
+
+			[[nodiscard]] std::uint64_t eq( char c ) const {
+				auto const needle = _mm256_set1_epi8( c );
+				auto const lo = static_cast<std::uint32_t>(
+				  _mm256_movemask_epi8( _mm256_cmpeq_epi8( m_lo, needle ) ) );
+				auto const hi = static_cast<std::uint32_t>(
+				  _mm256_movemask_epi8( _mm256_cmpeq_epi8( m_hi, needle ) ) );
+				return static_cast<std::uint64_t>( lo ) |
+				       ( static_cast<std::uint64_t>( hi ) << 32U );
+			}
+#elif defined( DAW_TEXT_TABLE_USE_SSE2 )
+			__m128i m_v0;
+			__m128i m_v1;
+			__m128i m_v2;
+			__m128i m_v3;
+
+			static std::uint64_t eq16( __m128i v, __m128i needle ) {
+				return static_cast<std::uint64_t>( static_cast<std::uint32_t>(
+				  _mm_movemask_epi8( _mm_cmpeq_epi8( v, needle ) ) ) );
+			}
+
+		public:
+			explicit simd_block( char const *ptr )
+			  : m_v0( _mm_loadu_si128( reinterpret_cast<__m128i const *>( ptr ) ) )
+			  , m_v1(
+			      _mm_loadu_si128( reinterpret_cast<__m128i const *>( ptr + 16 ) ) )
+			  , m_v2(
+			      _mm_loadu_si128( reinterpret_cast<__m128i const *>( ptr + 32 ) ) )
+			  , m_v3(
+			      _mm_loadu_si128( reinterpret_cast<__m128i const *>( ptr + 48 ) ) ) {}
+
+			[[nodiscard]] std::uint64_t eq( char c ) const {
+				auto const needle = _mm_set1_epi8( c );
+				return eq16( m_v0, needle ) | ( eq16( m_v1, needle ) << 16U ) |
+				       ( eq16( m_v2, needle ) << 32U ) | ( eq16( m_v3, needle ) << 48U );
+			}
+#else
+			char const *m_ptr;
+
+		public:
+			explicit simd_block( char const *ptr )
+			  : m_ptr( ptr ) {}
+
+			[[nodiscard]] std::uint64_t eq( char c ) const {
+				std::uint64_t result = 0;
+				for( std::size_t n = 0; n < block_size; ++n ) {
+					result |= static_cast<std::uint64_t>( m_ptr[n] == c ) << n;
+				}
+				return result;
+			}
+#endif
+		};
+
+		/***
+		 * Walks [first, last) a block at a time.  The final partial block is
+		 * copied into a padded buffer so that no reads happen past last.
+		 * @param visit called with the block, the number of valid bytes and the
+		 * offset of the block.  Returning true stops the walk
+		 */
+		template<typename CharT, typename Visitor>
+		inline void for_each_block( CharT const *first, CharT const *last,
+		                            Visitor &&visit ) {
+			static_assert( sizeof( CharT ) == 1,
+			               "Only single byte characters can be scanned in blocks" );
+			auto const sz = static_cast<std::size_t>( last - first );
+			std::size_t offset = 0;
+			while( offset + block_size <= sz ) {
+				if( visit( simd_block( reinterpret_cast<char const *>( first + offset ) ),
+				           block_size, offset ) ) {
+					return;
+				}
+				offset += block_size;
+			}
+			if( offset < sz ) {
+				char buff[block_size]{};
+				std::memcpy( buff, first + offset, sz - offset );
+				(void)visit( simd_block( buff ), sz - offset, offset );
+			}
+		}
+
+		[[nodiscard]] constexpr std::uint64_t valid_mask( std::size_t len ) {
+			return len >= block_size ? ~std::uint64_t{0}
+			                         : ( std::uint64_t{1} << len ) - 1U;
+		}
+
+		/***
+		 * Find the first newline that is not inside a quoted region
+		 * @param in_quote whether first is inside a quoted region
+		 * @return offset of newline or the size of the range when there isn't one
+		 */
+		template<typename CharT>
+		[[nodiscard]] inline std::size_t
+		find_row_end( CharT const *first, CharT const *last, CharT quote_char,
+		              CharT newline_char, bool in_quote = false ) {
+			auto result = static_cast<std::size_t>( last - first );
+			if constexpr( is_enabled_for<CharT> ) {
+				auto quote_carry = in_quote ? ~std::uint64_t{0} : std::uint64_t{0};
+				for_each_block(
+				  first, last,
+				  [&]( simd_block const &blk, std::size_t len, std::size_t offset ) {
+					  auto const quoted =
+					    prefix_xor( blk.eq( static_cast<char>( quote_char ) ) ) ^ quote_carry;
+					  auto const ends =
+					    blk.eq( static_cast<char>( newline_char ) ) & ~quoted & valid_mask( len );
+					  if( ends != 0 ) {
+						  result = offset + count_trailing_zeros( ends );
+						  return true;
+					  }
+					  quote_carry = carry_of( quoted );
+					  return false;
+				  } );
+			} else {
+				for( std::size_t n = 0; n < result; ++n ) {
+					if( first[n] == quote_char ) {
+						in_quote = not in_quote;
+					} else if( first[n] == newline_char and not in_quote ) {
+						return n;
+					}
+				}
+			}
+			return result;
+		}
+
+		/***
+		 * Is the number of quote characters in the range odd.  When it is, the
+		 * quoted state at last is the opposite of that at first
+		 */
+		template<typename CharT>
+		[[nodiscard]] inline bool has_odd_quote_count( CharT const *first,
+		                                               CharT const *last,
+		                                               CharT quote_char ) {
+			std::size_t count = 0;
+			if constexpr( is_enabled_for<CharT> ) {
+				for_each_block(
+				  first, last,
+				  [&]( simd_block const &blk, std::size_t len, std::size_t ) {
+					  count += popcount( blk.eq( static_cast<char>( quote_char ) ) & valid_mask( len ) );
+					  return false;
+				  } );
+			} else {
+				for( ; first != last; ++first ) {
+					count += static_cast<std::size_t>( *first == quote_char );
+				}
+			}
+			return ( count % 2U ) != 0;
+		}
+
+		struct row_end_counts {
+			// Unquoted newlines when the range starts outside of a quoted region
+			std::size_t unquoted_start = 0;
+			// Unquoted newlines when the range starts inside of a quoted region
+			std::size_t quoted_start = 0;
+			bool odd_quote_count = false;
+		};
+
+		/***
+		 * Count the newlines that end a row.  Both possible quoted states at
+		 * first are counted so that ranges can be counted independently and
+		 * combined in order afterwards using odd_quote_count
+		 */
+		template<typename CharT>
+		[[nodiscard]] inline row_end_counts
+		count_row_ends( CharT const *first, CharT const *last, CharT quote_char,
+		                CharT newline_char ) {
+			auto result = row_end_counts{};
+			if constexpr( is_enabled_for<CharT> ) {
+				std::uint64_t quote_carry = 0;
+				for_each_block(
+				  first, last,
+				  [&]( simd_block const &blk, std::size_t len, std::size_t ) {
+					  auto const quoted =
+					    prefix_xor( blk.eq( static_cast<char>( quote_char ) ) ) ^
+					    quote_carry;
+					  auto const newlines =
+					    blk.eq( static_cast<char>( newline_char ) ) & valid_mask( len );
+					  result.unquoted_start += popcount( newlines & ~quoted );
+					  result.quoted_start += popcount( newlines & quoted );
+					  quote_carry = carry_of( quoted );
+					  return false;
+				  } );
+				result.odd_quote_count = quote_carry != 0;
+			} else {
+				bool in_quote = false;
+				for( ; first != last; ++first ) {
+					if( *first == quote_char ) {
+						in_quote = not in_quote;
+					} else if( *first == newline_char ) {
+						if( in_quote ) {
+							++result.quoted_start;
+						} else {
+							++result.unquoted_start;
+						}
+					}
+				}
+				result.odd_quote_count = in_quote;
+			}
+			return result;
+		}
+
+		/***
+		 * Count each of the candidate characters outside of quoted regions, a row
+		 * at a time
+		 * @param on_row called with the counts of each row ending in a newline.
+		 * Returning true stops the count
+		 */
+		template<std::size_t N, typename OnRow>
+		inline void count_per_row( char const *first, char const *last,
+		                           char quote_char, char newline_char,
+		                           std::array<char, N> const &candidates,
+		                           OnRow &&on_row ) {
+			auto counts = std::array<std::size_t, N>{};
+			std::uint64_t quote_carry = 0;
+			for_each_block(
+			  first, last,
+			  [&]( simd_block const &blk, std::size_t len, std::size_t ) {
+				  auto const quoted = prefix_xor( blk.eq( quote_char ) ) ^ quote_carry;
+				  auto const unquoted = ~quoted & valid_mask( len );
+				  auto masks = std::array<std::uint64_t, N>{};
+				  for( std::size_t n = 0; n < N; ++n ) {
+					  masks[n] = blk.eq( candidates[n] ) & unquoted;
+				  }
+				  auto ends = blk.eq( newline_char ) & unquoted;
+				  while( ends != 0 ) {
+					  // The bits before the lowest row end
+					  auto const before = ( ends & ( ~ends + 1U ) ) - 1U;
+					  for( std::size_t n = 0; n < N; ++n ) {
+						  counts[n] += popcount( masks[n] & before );
+						  masks[n] &= ~before;
+					  }
+					  if( on_row( counts ) ) {
+						  return true;
+					  }
+					  counts = std::array<std::size_t, N>{};
+					  ends &= ends - 1U;
+				  }
+				  for( std::size_t n = 0; n < N; ++n ) {
+					  counts[n] += popcount( masks[n] );
+				  }
+				  quote_carry = carry_of( quoted );
+				  return false;
+			  } );
+		}
+
+		/***
+		 * Find the first delimiter or newline.  Quoting is not considered
+		 * @return offset of the terminator or the size of the range when there
+		 * isn't one
+		 */
+		[[nodiscard]] inline std::size_t find_cell_end( char const *first,
+		                                                char const *last,
+		                                                char delimiter_char,
+		                                                char newline_char ) {
+			auto result = static_cast<std::size_t>( last - first );
+			for_each_block(
+			  first, last,
+			  [&]( simd_block const &blk, std::size_t len, std::size_t offset ) {
+				  auto const ends = ( blk.eq( delimiter_char ) | blk.eq( newline_char ) ) &
+				                    valid_mask( len );
+				  if( ends != 0 ) {
+					  result = offset + count_trailing_zeros( ends );
+					  return true;
+				  }
+				  return false;
+			  } );
+			return result;
+		}
+
+		/***
+		 * Skip count cells of the current row without looking at their contents.
+		 * Delimiters inside of quoted regions do not end a cell
+		 * @pre first is at the start of a cell and count > 0
+		 * @return offset of the cell after the skipped cells, or of the newline
+		 * ending the row if it has fewer cells
+		 */
+		[[nodiscard]] inline std::size_t
+		skip_cells( char const *first, char const *last, char quote_char,
+		            char delimiter_char, char newline_char, std::size_t count ) {
+			auto result = static_cast<std::size_t>( last - first );
+			std::uint64_t quote_carry = 0;
+			for_each_block(
+			  first, last,
+			  [&]( simd_block const &blk, std::size_t len, std::size_t offset ) {
+				  auto const quoted = prefix_xor( blk.eq( quote_char ) ) ^ quote_carry;
+				  auto const unquoted = ~quoted & valid_mask( len );
+				  auto delimiters = blk.eq( delimiter_char ) & unquoted;
+				  auto const ends = blk.eq( newline_char ) & unquoted;
+				  if( ends != 0 ) {
+					  // Only the delimiters of this row count
+					  delimiters &= ( ends & ( ~ends + 1U ) ) - 1U;
+				  }
+				  auto const found = popcount( delimiters );
+				  if( found >= count ) {
+					  for( ; count > 1U; --count ) {
+						  delimiters &= delimiters - 1U;
+					  }
+					  result = offset + count_trailing_zeros( delimiters ) + 1U;
+					  return true;
+				  }
+				  if( ends != 0 ) {
+					  result = offset + count_trailing_zeros( ends );
+					  return true;
+				  }
+				  count -= found;
+				  quote_carry = carry_of( quoted );
+				  return false;
+			  } );
+			return result;
+		}
+
+		/***
+		 * Copy a cell to out, removing the escape before each escaped
+		 * character.  A quote_char escapes the next character, as in a doubled
+		 * quote, and so does escape_char when allow_escaped is set.  Runs of
+		 * plain characters are copied whole
+		 * @pre out has room for last - first characters
+		 * @return number of characters written
+		 */
+		template<typename CharT>
+		[[nodiscard]] inline std::size_t
+		unescape( CharT const *first, CharT const *last, CharT quote_char,
+		          CharT escape_char, bool allow_escaped, CharT *out ) {
+			auto const sz = static_cast<std::size_t>( last - first );
+			auto const out_first = out;
+			// The start of the characters that have not been copied yet
+			std::size_t copied = 0;
+			auto drop = [&]( std::size_t pos ) {
+				std::memcpy( out, first + copied, ( pos - copied ) * sizeof( CharT ) );
+				out += pos - copied;
+				copied = pos + 1U;
+			};
+			if constexpr( is_enabled_for<CharT> ) {
+				// The first character of the block is escaped by the end of the last
+				std::uint64_t escaped_carry = 0;
+				for_each_block(
+				  first, last,
+				  [&]( simd_block const &blk, std::size_t len, std::size_t offset ) {
+					  auto escapes = blk.eq( static_cast<char>( quote_char ) );
+					  if( allow_escaped ) {
+						  escapes |= blk.eq( static_cast<char>( escape_char ) );
+					  }
+					  escapes &= valid_mask( len ) & ~escaped_carry;
+					  escaped_carry = 0;
+					  while( escapes != 0 ) {
+						  auto const pos = count_trailing_zeros( escapes );
+						  drop( offset + pos );
+						  if( pos + 1U == block_size ) {
+							  escaped_carry = 1U;
+							  break;
+						  }
+						  // The escaped character is kept even if it is an escape
+						  escapes &= ~( std::uint64_t{3} << pos );
+					  }
+					  return false;
+				  } );
+			} else {
+				for( std::size_t n = 0; n < sz; ++n ) {
+					if( first[n] == quote_char or
+					    ( allow_escaped and first[n] == escape_char ) ) {
+						drop( n++ );
+					}
+				}
+			}
+			if( copied < sz ) {
+				drop( sz );
+			}
+			return static_cast<std::size_t>( out - out_first );
+		}
+	} // namespace structural
+} // namespace daw::text_data::text_table_details
@@ -0,0 +1,146 @@
+// The MIT License (MIT)
+//
+// Copyright (c) Darrell Wright
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and / or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include "daw/text_table/daw_text_table_link.h"
+
+#include <daw/daw_benchmark.h>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <new>
+#include <string>
+#include <string_view>
+
+// Count the heap allocations made by the parse so that the string columns
+// can be compared.  The array forms are replaced too, string_arena
+// allocates its blocks with new[].  This is its own program so that the
+// counting does not slow the benchmarks
+static std::atomic<std::size_t> allocation_count = 0;
+
+// GCC sees the free in the replaced operator delete after inlining and
+// reports it as a mismatch
+#if defined( __GNUC__ ) and not defined( __clang__ )
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+
+void *operator new( std::size_t size ) {
+	allocation_count.fetch_add( 1U, std::memory_order_relaxed );
+	if( auto ptr = std::malloc( size == 0 ? 1U : size ); ptr != nullptr ) {
+		return ptr;
+	}
+	throw std::bad_alloc( );
+}
+
+void operator delete( void *ptr ) noexcept {
+	std::free( ptr );
+}
+
+void operator delete( void *ptr, std::size_t ) noexcept {
+	std::free( ptr );
+}
+
+void *operator new[]( std::size_t size ) {
+	return operator new( size );
+}
+
+void operator delete[]( void *ptr ) noexcept {
+	std::free( ptr );
+}
+
+void operator delete[]( void *ptr, std::size_t ) noexcept {
+	std::free( ptr );
+}
+
+#if defined( __GNUC__ ) and not defined( __clang__ )
+#pragma GCC diagnostic pop
+#endif
+
+// The names copied out of the table
+struct names {
+	std::string city;
+	std::string region;
+};
+
+struct names_arena {
+	std::string_view city;
+	std::string_view region;
+};
+
+namespace daw::text_data {
+	template<>
+	struct text_data_contract<names> {
+		static constexpr char const city[] = "City";
+		static constexpr char const region[] = "Region";
+		using type = text_column_list<text_string<city>, text_string<region>>;
+	};
+
+	template<>
+	struct text_data_contract<names_arena> {
+		static constexpr char const city[] = "City";
+		static constexpr char const region[] = "Region";
+		using type =
+		  text_column_list<text_string_arena<city>, text_string_arena<region>>;
+	};
+} // namespace daw::text_data
+
+template<typename Function>
+std::size_t count_allocations( Function &&f ) {
+	auto const before = allocation_count.load( );
+	f( );
+	return allocation_count.load( ) - before;
+}
+
+int main( ) {
+	static constexpr int row_count = 10000;
+	std::string table = "City,Region\n";
+	for( int n = 0; n < row_count; ++n ) {
+		// Longer than the small string buffer of std::string
+		table += "a city with a long name " + std::to_string( n ) + ',';
+		table += "a region with a long name " + std::to_string( n % 50 ) + '\n';
+	}
+	auto const data_sv = std::string_view( table );
+
+	auto const array_allocations = count_allocations(
+	  [] { daw::do_not_optimize( std::make_unique<char[]>( 1 ) ); } );
+	daw_text_table_assert( array_allocations == 1,
+	                       "Allocation counter does not see new[]" );
+
+	auto const string_allocations = count_allocations( [&] {
+		daw::do_not_optimize( daw::text_data::parse_csv_table<names>( data_sv ) );
+	} );
+	auto const arena_allocations = count_allocations( [&] {
+		auto const rows = daw::text_data::parse_csv_table<
+		  names_arena, daw::text_data::arena_vector<names_arena>>( data_sv );
+		daw_text_table_assert( rows.size( ) == row_count and
+		                         rows[7].city == "a city with a long name 7",
+		                       "Expected every row" );
+	} );
+	printf( "allocations std::string: %zu text_string_arena: %zu\n",
+	        string_allocations, arena_allocations );
+	daw_text_table_assert( arena_allocations * 100U < string_allocations,
+	                       "Expected an allocation per block, not per cell" );
+}
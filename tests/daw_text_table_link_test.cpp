@@ -20,16 +20,174 @@
 // OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
 // SOFTWARE.
 
+// Errors are thrown so that invalid tables can be tested
+#define DAW_USE_TextTable_EXCEPTIONS
+
+#include "daw/text_table/daw_text_table_batch.h"
+#include "daw/text_table/daw_text_table_columns.h"
 #include "daw/text_table/daw_text_table_iterator.h"
 #include "daw/text_table/daw_text_table_link.h"
+#include "daw/text_table/daw_text_table_mapped.h"
+#include "daw/text_table/daw_text_table_parallel.h"
+#include "daw/text_table/daw_text_table_row_index.h"
+#include "daw/text_table/daw_text_table_sniff.h"
+#include "daw/text_table/daw_text_table_static.h"
+#include "daw/text_table/daw_text_table_stream.h"
+#include "daw/text_table/daw_text_table_writer.h"
 
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <clocale>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <limits>
 #include <string>
+#include <string_view>
 
 struct test_001 {
 	int n;
 	std::string s;
 };
 
+struct test_002 {
+	double x;
+	float y;
+};
+
+struct test_003 {
+	std::string_view d;
+	int a;
+	int c;
+};
+
+enum class colour { red, green, blue };
+
+struct colour_from_text {
+	constexpr colour operator( )( std::string_view cell ) const {
+		if( cell == "red" ) {
+			return colour::red;
+		}
+		if( cell == "green" ) {
+			return colour::green;
+		}
+		daw_text_table_assert( cell == "blue", "Unknown colour" );
+		return colour::blue;
+	}
+};
+
+struct colour_to_text {
+	constexpr std::string_view operator( )( colour c ) const {
+		switch( c ) {
+		case colour::red:
+			return "red";
+		case colour::green:
+			return "green";
+		case colour::blue:
+			break;
+		}
+		return "blue";
+	}
+};
+
+struct test_004 {
+	int a;
+	colour c;
+};
+
+struct test_005 {
+	std::chrono::time_point<std::chrono::system_clock, std::chrono::microseconds>
+	  t;
+	std::chrono::time_point<std::chrono::system_clock,
+	                        daw::text_data::timestamp_days>
+	  d;
+	std::chrono::system_clock::time_point e;
+};
+
+struct test_006 {
+	int a;
+	int f;
+};
+
+struct test_007 {
+	int a;
+	int e;
+};
+
+// test_003 with the columns found by their position
+struct test_008 {
+	std::string_view d;
+	int a;
+	int c;
+};
+
+// test_001 with header cells matched ignoring case and surrounding blanks
+struct test_009 {
+	int n;
+	std::string s;
+};
+
+// test_001 with the string copied to the arena of the result
+struct test_010 {
+	int n;
+	std::string_view s;
+};
+
+// test_010 with views of the table data for cells without escapes
+struct test_011 {
+	int n;
+	std::string_view s;
+};
+
+// A lookup table that is parsed at compile time
+struct test_012 {
+	std::string_view code;
+	int number;
+	double rate;
+};
+
+// A timestamp that is not a time_point but is built from one
+struct event_time {
+	using duration = std::chrono::seconds;
+
+	std::int64_t seconds_since_epoch;
+
+	explicit event_time(
+	  std::chrono::time_point<std::chrono::system_clock, duration> tp )
+	  : seconds_since_epoch( tp.time_since_epoch( ).count( ) ) {}
+};
+
+struct test_013 {
+	int id;
+	event_time when;
+};
+
+// Reals with more digits than the fast path takes
+struct test_014 {
+	long double x;
+	double y;
+};
+
+// A named column whose header is in the cell of a positional column
+struct test_015 {
+	int a;
+	int first;
+	int third;
+};
+
+// The limits of 64 bit integers
+struct test_016 {
+	std::int64_t a;
+	std::uint64_t b;
+};
+
+// Integers that are checked for narrowing
+struct test_017 {
+	std::uint8_t u;
+	std::int8_t i;
+};
+
 namespace daw::text_data {
 	template<>
 	struct text_data_contract<test_001> {
@@ -37,25 +195,961 @@ namespace daw::text_data {
 		static constexpr char const s[] = "s";
 
 		using type = text_column_list<text_number<a, int>, text_string<s>>;
+
+		static constexpr auto to_text_data( test_001 const &value ) {
+			return std::forward_as_tuple( value.n, value.s );
+		}
+	};
+
+	template<>
+	struct text_data_contract<test_002> {
+		static constexpr char const x[] = "x";
+		static constexpr char const y[] = "y";
+
+		using type = text_column_list<text_number<x>, text_number<y, float>>;
+
+		static constexpr auto to_text_data( test_002 const &value ) {
+			return std::forward_as_tuple( value.x, value.y );
+		}
+	};
+
+	template<>
+	struct text_data_contract<test_003> {
+		static constexpr char const a[] = "a";
+		static constexpr char const c[] = "c";
+		static constexpr char const d[] = "d";
+
+		using type = text_column_list<text_string_raw<d>, text_number<a, int>,
+		                              text_number<c, int>>;
+	};
+
+	template<>
+	struct text_data_contract<test_004> {
+		static constexpr char const a[] = "a";
+		static constexpr char const c[] = "c";
+
+		using type = text_column_list<
+		  text_number<a, int>,
+		  text_custom<c, colour, colour_from_text, colour_to_text>>;
+
+		static constexpr auto to_text_data( test_004 const &value ) {
+			return std::forward_as_tuple( value.a, value.c );
+		}
+	};
+
+	template<>
+	struct text_data_contract<test_006> {
+		static constexpr char const a[] = "a";
+		static constexpr char const b[] = "b";
+		static constexpr char const f[] = "f";
+
+		using type = text_column_list<text_number<a, int>, text_table_ignored<b>,
+		                              text_table_ignored<>, text_number<f, int>>;
+	};
+
+	template<>
+	struct text_data_contract<test_007> {
+		static constexpr char const e[] = "e";
+
+		using type = text_column_list<text_column_at<0, text_number<no_name, int>>,
+		                              text_number<e, int>>;
+
+		static constexpr auto to_text_data( test_007 const &value ) {
+			return std::forward_as_tuple( value.a, value.e );
+		}
+	};
+
+	template<>
+	struct text_data_contract<test_008> {
+		using type =
+		  text_column_list<text_column_at<3, text_string_raw<no_name>>,
+		                   text_column_at<0, text_number<no_name, int>>,
+		                   text_column_at<2, text_number<no_name, int>>>;
+
+		static constexpr auto to_text_data( test_008 const &value ) {
+			return std::forward_as_tuple( value.d, value.a, value.c );
+		}
+	};
+
+	template<>
+	struct text_data_contract<test_009> {
+		static constexpr char const a[] = "a";
+		static constexpr char const s[] = "s";
+
+		using type = basic_text_column_list<header_match::TrimmedCaseInsensitive,
+		                                    text_number<a, int>, text_string<s>>;
+	};
+
+	template<>
+	struct text_data_contract<test_010> {
+		static constexpr char const a[] = "a";
+		static constexpr char const s[] = "s";
+
+		using type = text_column_list<text_number<a, int>, text_string_arena<s>>;
+	};
+
+	template<>
+	struct text_data_contract<test_011> {
+		static constexpr char const a[] = "a";
+		static constexpr char const s[] = "s";
+
+		using type = text_column_list<text_number<a, int>, text_string_view<s>>;
+	};
+
+	template<>
+	struct text_data_contract<test_012> {
+		static constexpr char const code[] = "code";
+		static constexpr char const number[] = "number";
+		static constexpr char const rate[] = "rate";
+
+		using type =
+		  text_column_list<text_string_raw<code>, text_number<number, int>,
+		                   text_number<rate>>;
+
+		static constexpr auto to_text_data( test_012 const &value ) {
+			return std::forward_as_tuple( value.code, value.number, value.rate );
+		}
+	};
+
+	template<>
+	struct text_data_contract<test_013> {
+		static constexpr char const id[] = "id";
+		static constexpr char const when[] = "when";
+
+		using type = text_column_list<
+		  text_number<id, int>,
+		  text_timestamp<when, timestamp_format::YmdHms, event_time>>;
+	};
+
+	template<>
+	struct text_data_contract<test_014> {
+		static constexpr char const x[] = "x";
+		static constexpr char const y[] = "y";
+
+		using type =
+		  text_column_list<text_number<x, long double>, text_number<y>>;
+	};
+
+	template<>
+	struct text_data_contract<test_016> {
+		static constexpr char const a[] = "a";
+		static constexpr char const b[] = "b";
+
+		using type = text_column_list<text_number<a, std::int64_t>,
+		                              text_number<b, std::uint64_t>>;
+	};
+
+	template<>
+	struct text_data_contract<test_017> {
+		static constexpr char const u[] = "u";
+		static constexpr char const i[] = "i";
+
+		using type = text_column_list<
+		  text_number<u, std::uint8_t, NumericRangeCheck::CheckForNarrowing>,
+		  text_number<i, std::int8_t, NumericRangeCheck::CheckForNarrowing>>;
+	};
+
+	template<>
+	struct text_data_contract<test_015> {
+		static constexpr char const a[] = "a";
+
+		using type =
+		  text_column_list<text_number<a, int>,
+		                   text_column_at<0, text_number<no_name, int>>,
+		                   text_column_at<2, text_number<no_name, int>>>;
+	};
+
+	template<>
+	struct text_data_contract<test_005> {
+		static constexpr char const t[] = "t";
+		static constexpr char const d[] = "d";
+		static constexpr char const e[] = "e";
+
+		using type = text_column_list<
+		  text_timestamp<t>, text_date<d>,
+		  text_timestamp<e, timestamp_format::EpochMilliseconds,
+		                 std::chrono::system_clock::time_point>>;
+
+		static constexpr auto to_text_data( test_005 const &value ) {
+			return std::forward_as_tuple( value.t, value.d, value.e );
+		}
 	};
 } // namespace daw::text_data
 
+constexpr char const text_table12[] = "code,number,rate\n"
+                                      "USD,840,1.0\n"
+                                      "JPY,392,151.5\n"
+                                      "\"EUR\",978,0.92\n"
+                                      "GBP,826,0.79\n";
+
+// The table and its key index are built by the compiler
+constexpr auto currencies =
+  daw::text_data::parse_csv_table_static<test_012, 8, 0>( text_table12 );
+static_assert( currencies.size( ) == 4 and currencies[1].number == 392 );
+static_assert( currencies.find( "EUR" )->rate == 0.92 and
+               currencies.find( "USD" )->number == 840 and
+               not currencies.contains( "CAD" ) and
+               not currencies.contains( "AAA" ) and
+               not currencies.contains( "ZZZ" ) );
+constexpr auto currency_rows =
+  daw::text_data::parse_csv_table_static<test_012, 4>( text_table12 );
+static_assert( currency_rows.size( ) == 4 and
+               currency_rows[3].code == "GBP" );
+
+// Escaped cells of text_string_view columns are stored in the arena of an
+// arena_vector, so other containers must not compile
+static_assert(
+  daw::text_data::text_data_contract<test_011>::type::has_arena_columns and
+  not daw::text_data::text_data_contract<test_012>::type::has_arena_columns );
+
 constexpr char const text_table0[] = R"("a","s",d
 5,  hello, 33
 1,"bye", 44
 )";
 
+// Whether f reports a text table error
+template<typename Function>
+bool fails( Function &&f ) {
+	try {
+		(void)f( );
+	} catch( daw::text_data::text_table_exception const & ) {
+		return true;
+	}
+	return false;
+}
+
+// Whether parsing text as a table of T is an error
+template<typename T>
+bool fails_to_parse( std::string_view text ) {
+	return fails( [&] { return daw::text_data::parse_csv_table<T>( text ); } );
+}
+
 int main( ) {
 	auto tbl = daw::text_data::parse_csv_table<test_001>( text_table0 );
 	auto v0 = tbl[0].n + tbl[1].n;
 
 	using iter_t = daw::text_data::csv_table_iterator<test_001>;
 	auto first = iter_t( text_table0 );
-	constexpr auto last = iter_t( );
+	auto const last = iter_t( );
 	int v1 = 0;
 	while( first != last ) {
 		v1 += first->n;
 		++first;
 	}
 	daw_text_table_assert( v0 == v1, "Expected same" );
+
+	auto const cols = daw::text_data::parse_csv_columns<test_001>( text_table0 );
+	daw_text_table_assert( cols.size( ) == tbl.size( ), "Expected same rows" );
+	daw_text_table_assert( cols.column<0>( )[0] + cols.column<0>( )[1] == v0,
+	                       "Expected same" );
+	daw_text_table_assert( cols.column<1>( )[1] == "bye", "Expected bye" );
+
+	// The last cell is followed by more digits that are not part of the table
+	constexpr char const text_table1[] = "x,y\n0.1,1e-3\n-2.25,3.5e+10123";
+	auto const reals = daw::text_data::parse_csv_table<test_002>(
+	  std::string_view( text_table1, sizeof( text_table1 ) - 4U ) );
+	daw_text_table_assert( reals.size( ) == 2, "Expected 2 rows" );
+	daw_text_table_assert( reals[0].x == 0.1 and reals[0].y == 1e-3f,
+	                       "Expected 0.1 and 1e-3" );
+	daw_text_table_assert( reals[1].x == -2.25 and reals[1].y == 3.5e+10f,
+	                       "Expected -2.25 and 3.5e10" );
+
+	// Long decimals do not depend on the decimal point of the C locale
+	constexpr char const text_table13[] =
+	  "x,y\n1.25000000000000000000001,-2.50000000000000000000001\n";
+	auto const check_long_reals = [&] {
+		auto const long_reals =
+		  daw::text_data::parse_csv_table<test_014>( text_table13 );
+		daw_text_table_assert( long_reals.size( ) == 1 and
+		                         long_reals[0].x == 1.25000000000000000000001L and
+		                         long_reals[0].y == -2.5,
+		                       "Expected 1.25 and -2.5" );
+	};
+	check_long_reals( );
+	for( char const *comma_locale : {"de_DE.UTF-8", "fr_FR.UTF-8", "de_DE"} ) {
+		if( std::setlocale( LC_NUMERIC, comma_locale ) != nullptr ) {
+			check_long_reals( );
+			std::setlocale( LC_NUMERIC, "C" );
+			break;
+		}
+	}
+
+	// Integers up to the limits of their type, with 16 digits or more read a
+	// block at a time
+	auto const limits = daw::text_data::parse_csv_table<test_016>(
+	  "a,b\n-9223372036854775808,18446744073709551615\n"
+	  "9223372036854775807,+5\n"
+	  "+5,1234567890123456\n"
+	  "-1234567890123456789,12345678901234567\n" );
+	daw_text_table_assert(
+	  limits.size( ) == 4 and
+	    limits[0].a == std::numeric_limits<std::int64_t>::min( ) and
+	    limits[0].b == std::numeric_limits<std::uint64_t>::max( ) and
+	    limits[1].a == std::numeric_limits<std::int64_t>::max( ) and
+	    limits[1].b == 5U and limits[2].a == 5 and
+	    limits[2].b == 1234567890123456U and
+	    limits[3].a == -1234567890123456789 and
+	    limits[3].b == 12345678901234567U,
+	  "Expected the 64 bit limits" );
+	daw_text_table_assert(
+	  fails_to_parse<test_016>( "a,b\n1,18446744073709551616\n" ) and
+	    fails_to_parse<test_016>( "a,b\n9223372036854775808,1\n" ) and
+	    fails_to_parse<test_016>( "a,b\n-9223372036854775809,1\n" ),
+	  "Expected overflow errors" );
+	daw_text_table_assert( fails_to_parse<test_016>( "a,b\n,1\n" ) and
+	                         fails_to_parse<test_016>( "a,b\n1,\n" ),
+	                       "Expected empty cells to be errors" );
+	auto const narrow =
+	  daw::text_data::parse_csv_table<test_017>( "u,i\n255,-128\n" );
+	daw_text_table_assert( narrow.size( ) == 1 and narrow[0].u == 255 and
+	                         narrow[0].i == -128,
+	                       "Expected 255 and -128" );
+	daw_text_table_assert( fails_to_parse<test_017>( "u,i\n300,1\n" ) and
+	                         fails_to_parse<test_017>( "u,i\n1,-129\n" ),
+	                       "Expected narrowing errors" );
+
+	// Mapped columns that are out of order and not adjacent
+	constexpr char const text_table2[] = "a,b,c,d,e\n1,x,3,dd,5\n6,y,8,ee,10\n";
+	auto const sparse = daw::text_data::parse_csv_table<test_003>( text_table2 );
+	daw_text_table_assert( sparse.size( ) == 2, "Expected 2 rows" );
+	daw_text_table_assert( sparse[0].d == "dd" and sparse[0].a == 1 and
+	                         sparse[0].c == 3,
+	                       "Expected dd, 1 and 3" );
+	daw_text_table_assert( sparse[1].d == "ee" and sparse[1].a == 6 and
+	                         sparse[1].c == 8,
+	                       "Expected ee, 6 and 8" );
+
+	// The cells between mapped columns are skipped, including quoted
+	// delimiters and newlines
+	std::string const long_cell( 150, 'x' );
+	std::string const text_table8 = "a,b,c,d,e,f,g\n1,\"b,\n\",\"" + long_cell +
+	                                ",\"," + long_cell + ",,6,7\n8,b,c,d,e,13,g\n";
+	auto const ignored = daw::text_data::parse_csv_table<test_006>( text_table8 );
+	daw_text_table_assert( ignored.size( ) == 2 and ignored[0].a == 1 and
+	                         ignored[0].f == 6 and ignored[1].a == 8 and
+	                         ignored[1].f == 13,
+	                       "Expected 1, 6, 8 and 13" );
+	auto const ignored_cols =
+	  daw::text_data::parse_csv_columns<test_006>( text_table8 );
+	daw_text_table_assert( ignored_cols.column<0>( )[1] == 8 and
+	                         ignored_cols.column<3>( )[1] == 13,
+	                       "Expected 8 and 13" );
+
+	// Rows are filtered on the key cell before the other cells are read
+	auto const filtered = daw::text_data::parse_csv_table_if<test_003, 0>(
+	  text_table2, []( std::string_view d ) { return d == "ee"; } );
+	daw_text_table_assert( filtered.size( ) == 1 and filtered[0].a == 6 and
+	                         filtered[0].c == 8,
+	                       "Expected 6 and 8" );
+	auto const filtered_last = daw::text_data::parse_csv_table_if<test_003, 2>(
+	  "a,b,c,d,e\n1,\"x\ny\",3,dd,5\n6,y,8,ee,10",
+	  []( std::string_view c ) { return c == "3"; } );
+	daw_text_table_assert( filtered_last.size( ) == 1 and
+	                         filtered_last[0].d == "dd",
+	                       "Expected dd" );
+
+	// Positional columns need no header, or can be mixed with named columns
+	using no_header_t =
+	  daw::text_data::basic_csv_table_type<char, daw::text_data::NoHeaderRow>;
+	auto const positional = daw::text_data::parse_csv_table<test_008>(
+	  "1,x,3,dd,5\n6,y,8,ee,10\n", no_header_t{} );
+	daw_text_table_assert( positional.size( ) == 2 and positional[1].d == "ee" and
+	                         positional[1].a == 6 and positional[1].c == 8,
+	                       "Expected ee, 6 and 8" );
+	auto const positional_cols = daw::text_data::parse_csv_columns<test_008>(
+	  "1,x,3,dd,5\n6,y,8,ee,10\n", no_header_t{} );
+	daw_text_table_assert( positional_cols.size( ) == 2 and
+	                         positional_cols.column<0>( )[1] == "ee" and
+	                         positional_cols.column<1>( )[1] == 6 and
+	                         positional_cols.column<2>( )[0] == 3,
+	                       "Expected ee, 6 and 3" );
+	auto const with_header =
+	  daw::text_data::parse_csv_table<test_008>( text_table2 );
+	daw_text_table_assert( with_header.size( ) == 2 and with_header[0].d == "dd",
+	                       "Expected dd" );
+	auto const mixed = daw::text_data::parse_csv_table<test_007>( text_table2 );
+	daw_text_table_assert( mixed.size( ) == 2 and mixed[1].a == 6 and
+	                         mixed[1].e == 10,
+	                       "Expected 6 and 10" );
+	auto const shared =
+	  daw::text_data::parse_csv_table<test_015>( "a,b,c\n1,2,3\n4,5,6\n" );
+	daw_text_table_assert( shared.size( ) == 2 and shared[1].a == 4 and
+	                         shared[1].first == 4 and shared[1].third == 6,
+	                       "Expected 4, 4 and 6" );
+
+	// Header cells are matched by hash, a repeated header maps to its first
+	// column
+	constexpr char const text_table9[] = "b, S ,\" A\",a\n1,one,2,3\n";
+	auto const matched = daw::text_data::parse_csv_table<test_009>( text_table9 );
+	daw_text_table_assert( matched.size( ) == 1 and matched[0].n == 2 and
+	                         matched[0].s == "one",
+	                       "Expected 2 and one" );
+
+	// Arena strings have doubled quotes collapsed and outlive the input
+	using arena_table_t = daw::text_data::arena_vector<test_010>;
+	auto const arena_rows = [] {
+		auto const text_table10 =
+		  std::string( "a,s\n1,\"say \"\"hi\"\"\"\n2,bye\n" );
+		return daw::text_data::parse_csv_table<test_010, arena_table_t>(
+		  text_table10 );
+	}( );
+	daw_text_table_assert( arena_rows.size( ) == 2 and
+	                         arena_rows[0].s == "say \"hi\"" and
+	                         arena_rows[1].s == "bye" and
+	                         arena_rows.arena( ).block_count( ) == 1,
+	                       "Expected say \"hi\" and bye" );
+	auto const arena_parallel = [] {
+		auto text_table10 = std::string( "a,s\n" );
+		for( int n = 0; n < 1000; ++n ) {
+			text_table10 += std::to_string( n ) + ",\"s\"\"" + std::to_string( n ) +
+			                "\"\n";
+		}
+		return daw::text_data::parse_csv_table_parallel<test_010, arena_table_t>(
+		  text_table10, 4 );
+	}( );
+	daw_text_table_assert( arena_parallel.size( ) == 1000 and
+	                         arena_parallel[999].n == 999 and
+	                         arena_parallel[999].s == "s\"999",
+	                       "Expected s\"999" );
+
+	// Doubled quotes, and backslashes when the table allows them, are
+	// removed from string cells.  Cells without escapes are not copied
+	constexpr char const text_table11[] =
+	  "a,s\n1,\"say \"\"hi\"\"\"\n2,plain\n";
+	auto const unescaped =
+	  daw::text_data::parse_csv_table<test_001>( text_table11 );
+	daw_text_table_assert( unescaped.size( ) == 2 and
+	                         unescaped[0].s == "say \"hi\"" and
+	                         unescaped[1].s == "plain",
+	                       "Expected say \"hi\" and plain" );
+	auto const unescaped_cols =
+	  daw::text_data::parse_csv_columns<test_001>( text_table11 );
+	daw_text_table_assert( unescaped_cols.column<1>( )[0] == "say \"hi\"",
+	                       "Expected say \"hi\"" );
+	using escaped_table_t =
+	  daw::text_data::basic_csv_table_type<char, 0, 1, false, true, true>;
+	auto const backslashes = daw::text_data::parse_csv_table<test_001>(
+	  "a,s\n1,a\\,b\n2,\"c\\\"d\"\n", escaped_table_t{} );
+	daw_text_table_assert( backslashes.size( ) == 2 and
+	                         backslashes[0].s == "a,b" and
+	                         backslashes[1].s == "c\"d",
+	                       "Expected a,b and c\"d" );
+
+	// A quoted newline does not end a row, in the scalar tail of a short table
+	// and across the SIMD block boundary of a longer one, and the last row
+	// needs no newline
+	for( std::size_t pad : {std::size_t{0}, std::size_t{50}, std::size_t{55},
+	                        std::size_t{57}, std::size_t{58}, std::size_t{59},
+	                        std::size_t{60}, std::size_t{64}, std::size_t{130}} ) {
+		auto const row_end_table =
+		  "a,s\n1,\"" + std::string( pad, 'x' ) + "\ny\"\n2,z";
+		auto const check_rows = [&]( auto const &rows ) {
+			daw_text_table_assert(
+			  rows.size( ) == 2 and rows[0].s == std::string( pad, 'x' ) + "\ny" and
+			    rows[1].n == 2 and rows[1].s == "z",
+			  "Expected a quoted newline and a last row without a newline" );
+		};
+		check_rows( daw::text_data::parse_csv_table<test_001>( row_end_table ) );
+		check_rows( daw::text_data::parse_csv_table<test_001>( row_end_table,
+		                                                       escaped_table_t{} ) );
+	}
+	auto const escaped_newline = daw::text_data::parse_csv_table<test_001>(
+	  "a,s\n1,\"c\\\"\nd\"\n2,z", escaped_table_t{} );
+	daw_text_table_assert( escaped_newline.size( ) == 2 and
+	                         escaped_newline[0].s == "c\"\nd" and
+	                         escaped_newline[1].s == "z",
+	                       "Expected c\"\\nd and z" );
+	auto const views =
+	  daw::text_data::parse_csv_table<test_011,
+	                                  daw::text_data::arena_vector<test_011>>(
+	    text_table11 );
+	daw_text_table_assert( views.size( ) == 2 and views[0].s == "say \"hi\"" and
+	                         views[1].s.data( ) == text_table11 + 21,
+	                       "Expected say \"hi\" and a view of plain" );
+
+	// The keys of a static table are ordered, the first of equal keys is
+	// found
+	std::string shuffled_table = "code,number,rate\n";
+	for( int n = 0; n < 101; ++n ) {
+		shuffled_table += "k" + std::to_string( ( n * 37 ) % 101 ) + "," +
+		                  std::to_string( n ) + ",0\n";
+	}
+	shuffled_table += "k5,101,0\n";
+	auto const shuffled =
+	  daw::text_data::parse_csv_table_static<test_012, 128, 0>( shuffled_table );
+	for( int n = 0; n < 101; ++n ) {
+		auto const key = "k" + std::to_string( ( n * 37 ) % 101 );
+		auto const row = shuffled.find( std::string_view( key ) );
+		daw_text_table_assert( row != nullptr and row->number == n,
+		                       "Expected the row of the key" );
+	}
+	daw_text_table_assert( shuffled.size( ) == 102 and
+	                         not shuffled.contains( std::string_view( "k101" ) ),
+	                       "Expected 102 rows without k101" );
+
+	// Rows are parsed in batches into a reused buffer, resuming after the
+	// last row of the previous batch
+	auto cursor =
+	  daw::text_data::csv_row_cursor<test_001>( "a,s\n1,x\n2,y\n3,z\n" );
+	auto batch = std::array<test_001, 2>{};
+	auto const batch_size0 = daw::text_data::parse_rows( cursor, batch );
+	daw_text_table_assert( batch_size0 == 2 and batch[1].n == 2 and
+	                         batch[1].s == "y" and not cursor.at_end( ),
+	                       "Expected 2 rows ending with 2 and y" );
+	auto const batch_size1 = daw::text_data::parse_rows(
+	  cursor, batch.data( ), batch.data( ) + batch.size( ) );
+	daw_text_table_assert( batch_size1 == 1 and batch[0].n == 3 and
+	                         batch[0].s == "z" and cursor.at_end( ) and
+	                         daw::text_data::parse_rows( cursor, batch ) == 0,
+	                       "Expected 1 row of 3 and z" );
+
+	// Row views find the cells of a row and parse them when accessed
+	using view_iter_t = daw::text_data::csv_row_view_iterator<test_003>;
+	using test_003_contract = daw::text_data::text_data_contract<test_003>;
+	int view_sum = 0;
+	for( auto it = view_iter_t( text_table2 ); it != view_iter_t( ); ++it ) {
+		view_sum += it->get<1>( ) + it->get<test_003_contract::c>( );
+		if( it->cell<0>( ) == "ee" ) {
+			auto const row = it->value( );
+			daw_text_table_assert( row.a == 6 and row.c == 8, "Expected 6 and 8" );
+		}
+	}
+	daw_text_table_assert( view_sum == 18, "Expected 18" );
+	auto escaped_view =
+	  daw::text_data::csv_row_view_iterator<test_001>( text_table11 );
+	daw_text_table_assert( escaped_view->cell<1>( ) == "say \"\"hi\"\"" and
+	                         daw::text_data::get<1>( *escaped_view ) ==
+	                           "say \"hi\"",
+	                       "Expected say \"hi\"" );
+
+	// Custom columns are converted from the cell in the same pass
+	constexpr char const text_table6[] = "a,c\n1,green\n2,\"blue\"\n";
+	auto const colours = daw::text_data::parse_csv_table<test_004>( text_table6 );
+	daw_text_table_assert( colours.size( ) == 2 and
+	                         colours[0].c == colour::green and
+	                         colours[1].c == colour::blue,
+	                       "Expected green and blue" );
+
+	// Timestamps are UTC, epoch values before 1970 round down
+	constexpr char const text_table7[] =
+	  "t,d,e\n2024-02-29T12:34:56.789Z,2024-02-29,1709210096789\n"
+	  "1969-12-31T23:00:00.5-01:30,1900-03-01,-1500\n";
+	auto const times = daw::text_data::parse_csv_table<test_005>( text_table7 );
+	daw_text_table_assert( times.size( ) == 2, "Expected 2 rows" );
+	using std::chrono::milliseconds;
+	daw_text_table_assert(
+	  times[0].t.time_since_epoch( ) == milliseconds( 1709210096789 ) and
+	    times[0].d.time_since_epoch( ).count( ) == 19782 and
+	    times[0].e.time_since_epoch( ) == milliseconds( 1709210096789 ),
+	  "Expected 2024-02-29T12:34:56.789Z" );
+	daw_text_table_assert(
+	  times[1].t.time_since_epoch( ) == milliseconds( 1800500 ) and
+	    times[1].d.time_since_epoch( ).count( ) == -25508 and
+	    times[1].e.time_since_epoch( ) == milliseconds( -1500 ),
+	  "Expected 1970-01-01T00:30:00.5Z" );
+	auto const events = daw::text_data::parse_csv_table<test_013>(
+	  "id,when\n1,2024-02-29 12:34:56\n" );
+	daw_text_table_assert( events.size( ) == 1 and
+	                         events[0].when.seconds_since_epoch == 1709210096,
+	                       "Expected 2024-02-29 12:34:56" );
+
+	// Tables are written in the layout of their contract and read back as
+	// the same values
+	auto unescaped_text = std::string( );
+	daw::text_data::write_csv_table<test_001>( unescaped, unescaped_text );
+	daw_text_table_assert( unescaped_text == text_table11,
+	                       "Expected the same table" );
+	auto reals_text = std::string( );
+	daw::text_data::write_csv_table<test_002>( reals, reals_text );
+	auto const reals_back =
+	  daw::text_data::parse_csv_table<test_002>( reals_text );
+	daw_text_table_assert( reals_text == "x,y\n0.1,0.001\n-2.25,3.5e+10\n" and
+	                         reals_back[1].y == reals[1].y,
+	                       "Expected the same reals" );
+	auto colours_text = std::string( );
+	daw::text_data::write_csv_table<test_004>( colours, colours_text );
+	daw_text_table_assert( colours_text == "a,c\n1,green\n2,blue\n",
+	                       "Expected the same colours" );
+	auto times_text = std::string( );
+	daw::text_data::write_csv_table<test_005>( times, times_text );
+	auto const times_back =
+	  daw::text_data::parse_csv_table<test_005>( times_text );
+	daw_text_table_assert( times_text ==
+	                         "t,d,e\n2024-02-29T12:34:56.789000Z,2024-02-29,"
+	                         "1709210096789\n1970-01-01T00:30:00.500000Z,"
+	                         "1900-03-01,-1500\n",
+	                       "Expected the same timestamps" );
+	daw_text_table_assert( times_back[1].t == times[1].t and
+	                         times_back[1].d == times[1].d and
+	                         times_back[1].e == times[1].e,
+	                       "Expected the same timestamps" );
+
+	// Positional columns are written at their position and the other columns
+	// fill the remaining cells
+	auto positional_text = std::string( );
+	daw::text_data::write_csv_table<test_008>( positional, positional_text );
+	auto const positional_back =
+	  daw::text_data::parse_csv_table<test_008>( positional_text );
+	daw_text_table_assert( positional_text == ",,,\n1,,3,dd\n6,,8,ee\n" and
+	                         positional_back.size( ) == 2 and
+	                         positional_back[1].d == "ee" and
+	                         positional_back[1].a == 6 and
+	                         positional_back[1].c == 8,
+	                       "Expected the same positional values" );
+	// Cells that would read back as a comment row or without their leading
+	// blanks are quoted
+	using comment_dialect_t = daw::text_data::text_dialect<',', '"', '\\', '#'>;
+	auto const commented = std::vector<test_012>{{"#tag", 1, 0.5}, {"x", 2, 1.5}};
+	auto commented_text = std::string( );
+	daw::text_data::write_csv_table<test_012>( commented, commented_text,
+	                                           comment_dialect_t{} );
+	auto const commented_back = daw::text_data::parse_csv_table<test_012>(
+	  commented_text, comment_dialect_t{} );
+	daw_text_table_assert(
+	  commented_text == "code,number,rate\n\"#tag\",1,0.5\nx,2,1.5\n" and
+	    commented_back.size( ) == 2 and commented_back[0].code == "#tag" and
+	    commented_back[1].number == 2,
+	  "Expected the same rows" );
+	using skip_blanks_t = daw::text_data::basic_csv_table_type<char, 0, 1, true>;
+	auto const padded = std::vector<test_012>{{" padded", 3, 2.5}};
+	auto padded_text = std::string( );
+	daw::text_data::csv_table_writer<test_012, skip_blanks_t>( ).write(
+	  padded, padded_text );
+	auto const padded_back = daw::text_data::parse_csv_table<test_012>(
+	  padded_text, skip_blanks_t{} );
+	daw_text_table_assert( padded_back.size( ) == 1 and
+	                         padded_back[0].code == " padded",
+	                       "Expected the leading blank" );
+
+	auto mixed_text = std::string( );
+	daw::text_data::write_csv_table<test_007>( mixed, mixed_text );
+	auto const mixed_back =
+	  daw::text_data::parse_csv_table<test_007>( mixed_text );
+	daw_text_table_assert( mixed_text == ",e\n1,5\n6,10\n" and
+	                         mixed_back.size( ) == 2 and mixed_back[1].a == 6 and
+	                         mixed_back[1].e == 10,
+	                       "Expected the same mixed values" );
+
+	// \r\n row endings are not part of the last cell
+	constexpr char const text_table3[] = "a,s\r\n5,five\r\n6,\"six\"\r\n";
+	auto const crlf = daw::text_data::parse_csv_table<test_001>( text_table3 );
+	daw_text_table_assert( crlf.size( ) == 2 and crlf[0].s == "five" and
+	                         crlf[1].s == "six",
+	                       "Expected five and six" );
+
+	// Tab separated with comment rows
+	using tsv_comments = daw::text_data::text_dialect<'\t', '"', '\\', '#'>;
+	constexpr char const text_table4[] =
+	  "# exported\r\na\ts\r\n# skipped\r\n7\tseven\r\n8\teight\r\n";
+	auto const tsv =
+	  daw::text_data::parse_csv_table<test_001>( text_table4, tsv_comments{} );
+	daw_text_table_assert( tsv.size( ) == 2 and tsv[0].n == 7 and
+	                         tsv[0].s == "seven" and tsv[1].s == "eight",
+	                       "Expected seven and eight" );
+	daw_text_table_assert(
+	  daw::text_data::table_row_count( text_table4, tsv_comments{} ) == 3,
+	  "Expected header and data rows" );
+
+	// Dialect chosen at runtime
+	auto const pipe = daw::text_data::parse_csv_table<test_001>(
+	  "a|s\n9|nine\n", daw::text_data::runtime_dialect{'|'} );
+	daw_text_table_assert( pipe.size( ) == 1 and pipe[0].n == 9 and
+	                         pipe[0].s == "nine",
+	                       "Expected nine" );
+	auto const pipe_cols = daw::text_data::parse_csv_columns<test_001>(
+	  "a|s\n9|nine\n8|\"ei|ght\"\n", daw::text_data::runtime_dialect{'|'} );
+	daw_text_table_assert( pipe_cols.size( ) == 2 and
+	                         pipe_cols.column<0>( )[1] == 8 and
+	                         pipe_cols.column<1>( )[1] == "ei|ght",
+	                       "Expected 8 and ei|ght" );
+
+	// Sniff a tab separated table and parse it with the result
+	constexpr char const text_table5[] =
+	  "a\ts\tr\r\n1\t\"x\ty\"\t-2.5\r\n2\tz\t3\r\n";
+	auto const desc = daw::text_data::sniff_table( text_table5 );
+	daw_text_table_assert( desc.dialect.delimiter == '\t' and desc.has_header and
+	                         desc.line_endings ==
+	                           daw::text_data::line_ending::CrLf,
+	                       "Expected tab separated with a header and \\r\\n" );
+	daw_text_table_assert(
+	  desc.column_types.size( ) == 3 and
+	    desc.column_types[0] == daw::text_data::sniffed_type::Unsigned and
+	    desc.column_types[1] == daw::text_data::sniffed_type::String and
+	    desc.column_types[2] == daw::text_data::sniffed_type::Real,
+	  "Expected Unsigned, String and Real columns" );
+	auto const sniffed =
+	  daw::text_data::parse_csv_table<test_001>( text_table5, desc.dialect );
+	daw_text_table_assert( sniffed.size( ) == 2 and sniffed[0].s == "x\ty" and
+	                         sniffed[1].n == 2,
+	                       "Expected x\\ty and 2" );
+
+	// A sniffed table without a header is parsed by position
+	constexpr char const headerless_table[] = "1;x;3;dd\n6;y;8;ee\n";
+	auto const headerless_desc = daw::text_data::sniff_table( headerless_table );
+	daw_text_table_assert( headerless_desc.dialect.delimiter == ';' and
+	                         not headerless_desc.has_header,
+	                       "Expected ; separated without a header" );
+	auto const headerless = daw::text_data::parse_csv_table<test_008>(
+	  headerless_table,
+	  daw::text_data::basic_headerless_dialect_table_type<
+	    char, daw::text_data::runtime_dialect>( headerless_desc.dialect ) );
+	daw_text_table_assert( headerless.size( ) == 2 and headerless[0].a == 1 and
+	                         headerless[1].d == "ee" and headerless[1].c == 8,
+	                       "Expected 1, ee and 8" );
+
+	// The end of the sample can be inside of a quoted newline
+	std::string multi_line_table = "a,s,r\n";
+	for( int n = 0; n < 300; ++n ) {
+		multi_line_table += std::to_string( n ) + ",\"multi\nline cell\"," +
+		                    std::to_string( n ) + ".5\n";
+	}
+	for( std::size_t cut = 1000; cut <= 2100; cut += 10 ) {
+		auto const cut_desc = daw::text_data::sniff_table( multi_line_table, cut );
+		daw_text_table_assert(
+		  cut_desc.dialect.delimiter == ',' and cut_desc.has_header and
+		    cut_desc.column_types.size( ) == 3 and
+		    cut_desc.column_types[2] == daw::text_data::sniffed_type::Real,
+		  "Expected a header and Real values" );
+	}
+
+	// A ' that starts a value is only a quote when it closes a cell, and
+	// malformed rows are left out
+	constexpr char const apostrophe_table[] =
+	  "name,city\n'x,Paris\nbob,'s-Hertogenbosch\n";
+	auto const apostrophe_desc = daw::text_data::sniff_table( apostrophe_table );
+	daw_text_table_assert( apostrophe_desc.dialect.quote == '"' and
+	                         apostrophe_desc.dialect.delimiter == ',' and
+	                         apostrophe_desc.has_header,
+	                       "Expected \" quotes and a header" );
+	constexpr char const malformed_table[] = "a,b\n\"x\"y,1\n2,3\n4,5\n";
+	auto const malformed_desc = daw::text_data::sniff_table( malformed_table );
+	daw_text_table_assert(
+	  malformed_desc.dialect.delimiter == ',' and malformed_desc.has_header and
+	    malformed_desc.column_types.size( ) == 2 and
+	    malformed_desc.column_types[0] == daw::text_data::sniffed_type::Unsigned,
+	  "Expected a header and Unsigned values" );
+
+	// Large enough to be split, with newlines inside of quoted cells
+	std::string big_table = "a,s\n";
+	for( int n = 0; big_table.size( ) < 4U * 1024U * 1024U; ++n ) {
+		big_table += std::to_string( n );
+		big_table += n % 7 == 0 ? ",\"line\nbreak\"\n" : ",hello\n";
+	}
+	auto const seq = daw::text_data::parse_csv_table<test_001>( big_table );
+	auto const par =
+	  daw::text_data::parse_csv_table_parallel<test_001>( big_table, 4 );
+	daw_text_table_assert( seq.size( ) == par.size( ), "Expected same size" );
+	for( std::size_t n = 0; n < seq.size( ); ++n ) {
+		daw_text_table_assert( seq[n].n == par[n].n and seq[n].s == par[n].s,
+		                       "Expected same rows" );
+	}
+	// Uneven pieces through a small buffer so rows and quoted cells straddle
+	// the piece boundaries
+	auto stream = daw::text_data::streaming_csv_parser<test_001>( 4096 );
+	std::size_t streamed = 0;
+	auto check_row = [&]( test_001 const &row ) {
+		daw_text_table_assert( streamed < seq.size( ) and
+		                         row.n == seq[streamed].n and
+		                         row.s == seq[streamed].s,
+		                       "Expected same rows" );
+		++streamed;
+	};
+	auto big_view = std::string_view( big_table );
+	for( std::size_t n = 0; not big_view.empty( ); ++n ) {
+		auto const piece = std::min( big_view.size( ), 1U + ( n * 37U ) % 1000U );
+		stream.push( big_view.substr( 0, piece ), check_row );
+		big_view.remove_prefix( piece );
+	}
+	stream.finish( check_row );
+	daw_text_table_assert( streamed == seq.size( ), "Expected all rows" );
+	// A blank row that arrives on its own is skipped, as it is when the
+	// whole table is parsed
+	auto blank_stream = daw::text_data::streaming_csv_parser<test_001>( 64 );
+	std::size_t blank_rows = 0;
+	auto count_blank_row = [&]( test_001 const & ) { ++blank_rows; };
+	blank_stream.push( "a,s\n1,x\n2,y\n", count_blank_row );
+	blank_stream.push( "\n", count_blank_row );
+	blank_stream.push( "\r\n", count_blank_row );
+	blank_stream.finish( count_blank_row );
+	daw_text_table_assert(
+	  blank_rows == 2 and
+	    daw::text_data::parse_csv_table<test_001>( "a,s\n1,x\n2,y\n\n" ).size( ) ==
+	      2,
+	  "Expected 2 rows" );
+
+	auto big_text = std::string( );
+	daw::text_data::write_csv_table<test_001>( seq, big_text );
+	daw_text_table_assert( big_text == big_table, "Expected the same table" );
+	big_text.clear( );
+	daw::text_data::write_csv_table_parallel<test_001>( seq, big_text, 4 );
+	daw_text_table_assert( big_text == big_table, "Expected the same table" );
+
+	auto const row_count = daw::text_data::table_row_count( big_table );
+	daw_text_table_assert( row_count == seq.size( ) + 1U,
+	                       "Expected header and data rows" );
+	daw_text_table_assert(
+	  daw::text_data::table_row_count_parallel( big_table, 4 ) == row_count,
+	  "Expected same row count" );
+
+	// A quote in a comment row does not open a quoted cell
+	using csv_comments = daw::text_data::text_dialect<',', '"', '\\', '#'>;
+	std::string comment_table = "a,s\n";
+	for( int n = 0; comment_table.size( ) < 4U * 1024U * 1024U; ++n ) {
+		comment_table += std::to_string( n ) + ",\"x\ny\"\n";
+		if( n == 5000 ) {
+			comment_table += "# don't \"quote this\n";
+		}
+	}
+	auto const comment_seq =
+	  daw::text_data::parse_csv_table<test_001>( comment_table, csv_comments{} );
+	auto const comment_par = daw::text_data::parse_csv_table_parallel<test_001>(
+	  comment_table, csv_comments{}, 4 );
+	daw_text_table_assert( comment_par.size( ) == comment_seq.size( ) and
+	                         comment_par.back( ).n == comment_seq.back( ).n,
+	                       "Expected same rows" );
+	auto comment_stream = daw::text_data::streaming_csv_parser<
+	  test_001, daw::text_data::basic_dialect_table_type<char, csv_comments>>(
+	  4096 );
+	std::size_t comment_streamed = 0;
+	auto check_comment_row = [&]( test_001 const &row ) {
+		daw_text_table_assert( comment_streamed < comment_seq.size( ) and
+		                         row.n == comment_seq[comment_streamed].n,
+		                       "Expected same rows" );
+		++comment_streamed;
+	};
+	auto comment_view = std::string_view( comment_table );
+	while( not comment_view.empty( ) ) {
+		auto const piece = std::min( comment_view.size( ), std::size_t{1000} );
+		comment_stream.push( comment_view.substr( 0, piece ), check_comment_row );
+		comment_view.remove_prefix( piece );
+	}
+	comment_stream.finish( check_comment_row );
+	daw_text_table_assert( comment_streamed == comment_seq.size( ),
+	                       "Expected all rows" );
+
+	// Rows are reached from the nearest indexed row, the index is kept in a
+	// sidecar file that is rebuilt when the table changes
+	auto const index = daw::text_data::build_row_index( big_table, 100 );
+	daw_text_table_assert( index.row_count( ) == seq.size( ) and
+	                         index.offsets( ).size( ) ==
+	                           ( seq.size( ) + 99U ) / 100U,
+	                       "Expected every 100th row" );
+	auto seek_it = iter_t( big_table );
+	for( std::size_t row : {std::size_t{0}, std::size_t{7}, std::size_t{100},
+	                        std::size_t{12345}, seq.size( ) - 1U} ) {
+		seek_it.seek_row( index, row );
+		daw_text_table_assert( seek_it->n == seq[row].n and
+		                         seek_it->s == seq[row].s,
+		                       "Expected the seeked row" );
+	}
+	daw_text_table_assert( ++seek_it == last and
+	                         seek_it.seek_row( index, seq.size( ) ) == last,
+	                       "Expected the end of the table" );
+	auto seek_view = daw::text_data::csv_row_view_iterator<test_001>( big_table );
+	seek_view.seek_row( index, 700 );
+	daw_text_table_assert( seek_view->get<0>( ) == seq[700].n,
+	                       "Expected the seeked row" );
+	auto const other_index = daw::text_data::build_row_index( text_table0, 1 );
+	daw_text_table_assert(
+	  fails( [&] { seek_it.seek_row( other_index, 1 ); } ) and
+	    fails( [&] { seek_view.seek_row( other_index, 1 ); } ),
+	  "Expected an index of another table to be rejected" );
+
+	auto const index_path =
+	  ( std::filesystem::temp_directory_path( ) / "daw_text_table_row_index" )
+	    .string( );
+	daw_text_table_assert( index.save( index_path ), "Expected a saved index" );
+	auto const loaded = daw::text_data::row_index::load(
+	  index_path, daw::text_data::make_row_index_key<char>( big_table ) );
+	daw_text_table_assert( loaded and loaded->offsets( ) == index.offsets( ),
+	                       "Expected the same index" );
+	auto changed_table = big_table;
+	changed_table.back( ) = ' ';
+	daw_text_table_assert(
+	  not daw::text_data::row_index::load(
+	    index_path, daw::text_data::make_row_index_key<char>( changed_table ) ),
+	  "Expected the index of a changed table to be rejected" );
+	auto bad_offsets = index.offsets( );
+	std::swap( bad_offsets[1], bad_offsets[2] );
+	daw_text_table_assert(
+	  daw::text_data::row_index( 100, index.row_count( ), index.key( ),
+	                             bad_offsets )
+	      .save( index_path ) and
+	    not daw::text_data::row_index::load( index_path, index.key( ) ),
+	  "Expected offsets out of order to be rejected" );
+	bad_offsets = index.offsets( );
+	bad_offsets.back( ) = index.key( ).size;
+	daw_text_table_assert(
+	  daw::text_data::row_index( 100, index.row_count( ), index.key( ),
+	                             bad_offsets )
+	      .save( index_path ) and
+	    not daw::text_data::row_index::load( index_path, index.key( ) ),
+	  "Expected offsets past the table to be rejected" );
+	std::filesystem::remove( index_path );
+
+	// The sidecar of a table file is rebuilt when its size or modification
+	// time changes
+	auto const table_path =
+	  ( std::filesystem::temp_directory_path( ) / "daw_text_table_row_table" )
+	    .string( );
+	auto const write_table = [&]( std::string const &contents ) {
+		std::ofstream( table_path, std::ios::binary | std::ios::trunc )
+		  << contents;
+	};
+	write_table( big_table );
+	auto const built = daw::text_data::load_or_build_row_index(
+	  table_path, big_table, index_path, 100 );
+	auto const reloaded = daw::text_data::load_or_build_row_index(
+	  table_path, big_table, index_path, 100 );
+	daw_text_table_assert( built.offsets( ) == index.offsets( ) and
+	                         reloaded.key( ) == built.key( ) and
+	                         reloaded.offsets( ) == built.offsets( ),
+	                       "Expected the saved index" );
+	auto const grown_table = big_table + "1,one more\n";
+	write_table( grown_table );
+	auto const grown = daw::text_data::load_or_build_row_index(
+	  table_path, grown_table, index_path, 100 );
+	daw_text_table_assert( grown.row_count( ) == seq.size( ) + 1U and
+	                         grown.key( ).size == grown_table.size( ),
+	                       "Expected the index to be rebuilt for the new size" );
+	std::filesystem::last_write_time(
+	  table_path, std::filesystem::last_write_time( table_path ) -
+	                std::chrono::hours( 1 ) );
+	auto const touched = daw::text_data::load_or_build_row_index(
+	  table_path, grown_table, index_path, 100 );
+	daw_text_table_assert(
+	  touched.key( ).mtime == daw::text_data::file_mtime( table_path ) and
+	    touched.key( ).mtime != grown.key( ).mtime and
+	    touched.row_count( ) == grown.row_count( ) and
+	    daw::text_data::row_index::load( index_path, touched.key( ) ),
+	  "Expected the index to be rebuilt for the new modification time" );
+	std::filesystem::remove( index_path );
+
+	// A mapped table parses the same as the table in memory, with a window
+	// small enough that pages are requested and released during the parse
+	write_table( big_table );
+	{
+		auto const mapped =
+		  daw::text_data::mapped_csv_table<test_001>( table_path, 64U * 1024U );
+		auto const same_row = []( test_001 const &lhs, test_001 const &rhs ) {
+			return lhs.n == rhs.n and lhs.s == rhs.s;
+		};
+		auto const mapped_rows = mapped.parse( );
+		daw_text_table_assert( mapped.data( ) == big_table and
+		                         std::equal( mapped_rows.begin( ),
+		                                     mapped_rows.end( ), seq.begin( ),
+		                                     seq.end( ), same_row ),
+		                       "Expected same rows" );
+		daw_text_table_assert( std::equal( mapped.begin( ), mapped.end( ),
+		                                   seq.begin( ), seq.end( ), same_row ),
+		                       "Expected same rows" );
+	}
+	std::filesystem::remove( table_path );
+
+	auto const par_indexed =
+	  daw::text_data::parse_csv_table_parallel<test_001>( big_table, index, 4 );
+	daw_text_table_assert( par_indexed.size( ) == seq.size( ) and
+	                         par_indexed.back( ).n == seq.back( ).n and
+	                         par_indexed[12345].s == seq[12345].s,
+	                       "Expected same rows" );
 }
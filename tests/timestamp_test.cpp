@@ -0,0 +1,131 @@
+// The MIT License (MIT)
+//
+// Copyright (c) Darrell Wright
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and / or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "daw/text_table/daw_text_table_link.h"
+
+#include <daw/daw_benchmark.h>
+
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <ctime>
+#include <iomanip>
+#include <locale>
+#include <sstream>
+#include <string>
+#include <string_view>
+
+using time_point_t =
+  std::chrono::time_point<std::chrono::system_clock, std::chrono::seconds>;
+
+struct event_t {
+	int id;
+	time_point_t when;
+};
+
+struct raw_event_t {
+	int id;
+	std::string_view when;
+};
+
+namespace daw::text_data {
+	template<>
+	struct text_data_contract<event_t> {
+		static constexpr char const id[] = "id";
+		static constexpr char const when[] = "when";
+		using type = text_column_list<
+		  text_number<id, int>,
+		  text_timestamp<when, timestamp_format::YmdHms, time_point_t>>;
+	};
+
+	template<>
+	struct text_data_contract<raw_event_t> {
+		static constexpr char const id[] = "id";
+		static constexpr char const when[] = "when";
+		using type =
+		  text_column_list<text_number<id, int>, text_string_raw<when>>;
+	};
+} // namespace daw::text_data
+
+/***
+ * The same conversion with the standard library: std::get_time on a
+ * stringstream imbued with the classic locale
+ */
+time_point_t get_time_parse( std::string_view when ) {
+	std::tm tm{};
+	std::istringstream ss{std::string( when )};
+	ss.imbue( std::locale::classic( ) );
+	ss >> std::get_time( &tm, "%Y-%m-%d %H:%M:%S" );
+	daw_text_table_assert( not ss.fail( ), "Invalid timestamp" );
+	auto const days = daw::text_data::text_table_details::days_from_civil(
+	  tm.tm_year + 1900, static_cast<unsigned>( tm.tm_mon + 1 ),
+	  static_cast<unsigned>( tm.tm_mday ) );
+	return time_point_t( std::chrono::seconds(
+	  days * 86400 + tm.tm_hour * 3600 + tm.tm_min * 60 + tm.tm_sec ) );
+}
+
+int main( ) {
+#ifdef NDEBUG
+	static constexpr std::size_t num_runs = 10;
+	static constexpr int num_rows = 1'000'000;
+#else
+	static constexpr std::size_t num_runs = 1;
+	static constexpr int num_rows = 10'000;
+#endif
+	std::string table = "id,when\n";
+	for( int n = 0; n < num_rows; ++n ) {
+		auto const t = std::time_t( 1'500'000'000 ) + std::time_t( n ) * 7919;
+		char buff[32];
+		auto const len = std::strftime( buff, sizeof( buff ), "%Y-%m-%d %H:%M:%S",
+		                                std::gmtime( &t ) );
+		table += std::to_string( n );
+		table += ',';
+		table.append( buff, len );
+		table += '\n';
+	}
+	auto const data_sv = std::string_view( table );
+
+	auto const parsed = daw::text_data::parse_csv_table<event_t>( data_sv );
+	auto const raw = daw::text_data::parse_csv_table<raw_event_t>( data_sv );
+	daw_text_table_assert( parsed.size( ) == raw.size( ), "Expected same rows" );
+	for( std::size_t n = 0; n < parsed.size( ); ++n ) {
+		daw_text_table_assert( parsed[n].when == get_time_parse( raw[n].when ),
+		                       "Expected same time" );
+	}
+
+	daw::bench_n_test_mbs<num_runs>(
+	  "parse_csv_table text_timestamp", data_sv.size( ),
+	  []( auto rng ) {
+		  daw::do_not_optimize( daw::text_data::parse_csv_table<event_t>( rng ) );
+	  },
+	  data_sv );
+
+	daw::bench_n_test_mbs<num_runs>(
+	  "parse_csv_table std::get_time", data_sv.size( ),
+	  []( auto rng ) {
+		  auto const rows = daw::text_data::parse_csv_table<raw_event_t>( rng );
+		  for( auto const &row : rows ) {
+			  daw::do_not_optimize( get_time_parse( row.when ) );
+		  }
+	  },
+	  data_sv );
+}
@@ -0,0 +1,87 @@
+// The MIT License (MIT)
+//
+// Copyright (c) Darrell Wright
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and / or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "daw/text_table/daw_text_table_link.h"
+
+#include <daw/daw_benchmark.h>
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+// 12 mapped columns of a 20000 column header
+struct wide_row {
+	int c0, c1, c2, c3, c4, c5, c6, c7, c8, c9, c10, c11;
+};
+
+namespace daw::text_data {
+	template<>
+	struct text_data_contract<wide_row> {
+		static constexpr char const c0[] = "col_1000";
+		static constexpr char const c1[] = "col_2600";
+		static constexpr char const c2[] = "col_4200";
+		static constexpr char const c3[] = "col_5800";
+		static constexpr char const c4[] = "col_7400";
+		static constexpr char const c5[] = "col_9000";
+		static constexpr char const c6[] = "col_10600";
+		static constexpr char const c7[] = "col_12200";
+		static constexpr char const c8[] = "col_13800";
+		static constexpr char const c9[] = "col_15400";
+		static constexpr char const c10[] = "col_17000";
+		static constexpr char const c11[] = "col_18600";
+		using type = text_column_list<
+		  text_number<c0, int>, text_number<c1, int>, text_number<c2, int>,
+		  text_number<c3, int>, text_number<c4, int>, text_number<c5, int>,
+		  text_number<c6, int>, text_number<c7, int>, text_number<c8, int>,
+		  text_number<c9, int>, text_number<c10, int>, text_number<c11, int>>;
+	};
+} // namespace daw::text_data
+
+int main( ) {
+#ifdef NDEBUG
+	static constexpr std::size_t num_runs = 100;
+#else
+	static constexpr std::size_t num_runs = 1;
+#endif
+	static constexpr int column_count = 20000;
+	std::string table{};
+	for( int n = 0; n < column_count; ++n ) {
+		table += "col_" + std::to_string( n );
+		table += n + 1 < column_count ? ',' : '\n';
+	}
+	for( int n = 0; n < column_count; ++n ) {
+		table += std::to_string( n % 7 );
+		table += n + 1 < column_count ? ',' : '\n';
+	}
+	auto const data_sv = std::string_view( table );
+
+	auto const rows = daw::text_data::parse_csv_table<wide_row>( data_sv );
+	daw_text_table_assert( rows.size( ) == 1 and rows[0].c11 == 1,
+	                       "Expected col_18600" );
+
+	daw::bench_n_test_mbs<num_runs>(
+	  "parse_csv_table wide header", data_sv.size( ),
+	  []( auto rng ) {
+		  daw::do_not_optimize( daw::text_data::parse_csv_table<wide_row>( rng ) );
+	  },
+	  data_sv );
+}
@@ -20,15 +20,24 @@
 // OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
 // SOFTWARE.
 
+#include "daw/text_table/daw_text_table_batch.h"
+#include "daw/text_table/daw_text_table_columns.h"
 #include "daw/text_table/daw_text_table_iterator.h"
 #include "daw/text_table/daw_text_table_link.h"
+#include "daw/text_table/daw_text_table_mapped.h"
+#include "daw/text_table/daw_text_table_parallel.h"
+#include "daw/text_table/daw_text_table_row_index.h"
+#include "daw/text_table/daw_text_table_sniff.h"
+#include "daw/text_table/daw_text_table_writer.h"
 
 #include <daw/daw_benchmark.h>
-#include <daw/daw_memory_mapped_file.h>
 
+#include <algorithm>
 #include <cstdio>
-#include <iterator>
+#include <cstdlib>
 #include <string>
+#include <utility>
+#include <vector>
 
 struct world_cities_pop {
 	std::string_view country;
@@ -40,6 +49,43 @@ struct world_cities_pop {
 	std::string_view longitude;
 };
 
+struct world_cities_latitude {
+	std::string_view country;
+	std::string_view latitude;
+};
+
+// The same cells found by their position in the row
+struct world_cities_latitude_at {
+	std::string_view country;
+	std::string_view latitude;
+};
+
+// The names copied out of the table
+struct world_cities_names {
+	std::string city;
+	std::string accentcity;
+	std::string region;
+};
+
+struct world_cities_names_arena {
+	std::string_view city;
+	std::string_view accentcity;
+	std::string_view region;
+};
+
+struct world_cities_names_view {
+	std::string_view city;
+	std::string_view accentcity;
+	std::string_view region;
+};
+
+struct world_cities_coords {
+	std::string_view country;
+	std::string_view city;
+	double latitude;
+	double longitude;
+};
+
 struct empty {};
 
 namespace daw::text_data {
@@ -59,6 +105,72 @@ namespace daw::text_data {
 		                   text_string_raw<longitude>>;
 	};
 
+	template<>
+	struct text_data_contract<world_cities_latitude> {
+		static constexpr char const country[] = "Country";
+		static constexpr char const city[] = "City";
+		static constexpr char const accentcity[] = "AccentCity";
+		static constexpr char const region[] = "Region";
+		static constexpr char const population[] = "Population";
+		static constexpr char const latitude[] = "Latitude";
+		using type = text_column_list<
+		  text_string_raw<country>, text_table_ignored<city>,
+		  text_table_ignored<accentcity>, text_table_ignored<region>,
+		  text_table_ignored<population>, text_string_raw<latitude>>;
+	};
+
+	template<>
+	struct text_data_contract<world_cities_latitude_at> {
+		using type =
+		  text_column_list<text_column_at<0, text_string_raw<no_name>>,
+		                   text_column_at<5, text_string_raw<no_name>>>;
+	};
+
+	template<>
+	struct text_data_contract<world_cities_names> {
+		static constexpr char const city[] = "City";
+		static constexpr char const accentcity[] = "AccentCity";
+		static constexpr char const region[] = "Region";
+		using type = text_column_list<text_string<city>, text_string<accentcity>,
+		                              text_string<region>>;
+	};
+
+	template<>
+	struct text_data_contract<world_cities_names_arena> {
+		static constexpr char const city[] = "City";
+		static constexpr char const accentcity[] = "AccentCity";
+		static constexpr char const region[] = "Region";
+		using type =
+		  text_column_list<text_string_arena<city>, text_string_arena<accentcity>,
+		                   text_string_arena<region>>;
+	};
+
+	template<>
+	struct text_data_contract<world_cities_names_view> {
+		static constexpr char const city[] = "City";
+		static constexpr char const accentcity[] = "AccentCity";
+		static constexpr char const region[] = "Region";
+		using type =
+		  text_column_list<text_string_view<city>, text_string_view<accentcity>,
+		                   text_string_view<region>>;
+	};
+
+	template<>
+	struct text_data_contract<world_cities_coords> {
+		static constexpr char const country[] = "Country";
+		static constexpr char const city[] = "City";
+		static constexpr char const latitude[] = "Latitude";
+		static constexpr char const longitude[] = "Longitude";
+		using type =
+		  text_column_list<text_string_raw<country>, text_string_raw<city>,
+		                   text_number<latitude>, text_number<longitude>>;
+
+		static constexpr auto to_text_data( world_cities_coords const &value ) {
+			return std::forward_as_tuple( value.country, value.city, value.latitude,
+			                              value.longitude );
+		}
+	};
+
 	template<>
 	struct text_data_contract<empty> {
 		using type = text_column_list<>;
@@ -66,17 +178,13 @@ namespace daw::text_data {
 } // namespace daw::text_data
 
 int main( int argc, char **argv ) {
-	std::vector<char> data_vec{};
-	{
-		if( argc <= 1 ) {
-			puts( "Must supply path to worldcitiespop.txt\n" );
-			exit( EXIT_FAILURE );
-		}
-		auto const data = daw::filesystem::memory_mapped_file_t<>( argv[1] );
-		data_vec.reserve( data.size( ) );
-		std::copy( data.begin( ), data.end( ), std::back_inserter( data_vec ) );
+	if( argc <= 1 ) {
+		puts( "Must supply path to worldcitiespop.txt\n" );
+		exit( EXIT_FAILURE );
 	}
-	auto data_sv = std::string_view( data_vec.data( ), data_vec.size( ) );
+	auto const table =
+	  daw::text_data::mapped_csv_table<world_cities_pop>( argv[1] );
+	auto data_sv = table.data( );
 
 	using iter_t = daw::text_data::csv_table_iterator<world_cities_pop>;
 	auto first = iter_t( data_sv );
@@ -87,6 +195,13 @@ int main( int argc, char **argv ) {
 #else
 	static constexpr std::size_t num_runs = 1;
 #endif
+	auto const sniff_size =
+	  std::min( data_sv.size( ), daw::text_data::text_table_details::default_sniff_size );
+	daw::bench_n_test_mbs<num_runs>(
+	  "sniff_table", sniff_size,
+	  []( auto rng ) { daw::do_not_optimize( daw::text_data::sniff_table( rng ) ); },
+	  data_sv );
+
 	daw::bench_n_test_mbs<num_runs>(
 	  "world cities population", data_sv.size( ),
 	  []( iter_t f ) {
@@ -97,11 +212,306 @@ int main( int argc, char **argv ) {
 	  },
 	  first );
 
+	daw::bench_n_test_mbs<num_runs>(
+	  "parse_csv_table", data_sv.size( ),
+	  []( auto rng ) {
+		  daw::do_not_optimize(
+		    daw::text_data::parse_csv_table<world_cities_pop>( rng ) );
+	  },
+	  data_sv );
+
+	// A batch of 1024 rows is 112KiB and stays in the L2 cache
+	daw::bench_n_test_mbs<num_runs>(
+	  "parse_rows 1024 row batches", data_sv.size( ),
+	  []( auto rng ) {
+		  auto cursor = daw::text_data::csv_row_cursor<world_cities_pop>( rng );
+		  auto batch = std::vector<world_cities_pop>( 1024U );
+		  std::size_t row_count = 0;
+		  while( auto const count = daw::text_data::parse_rows( cursor, batch ) ) {
+			  daw::do_not_optimize( batch );
+			  row_count += count;
+		  }
+		  daw::do_not_optimize( row_count );
+	  },
+	  data_sv );
+
+	// A selective filter on the first column, parsing every row and then
+	// filtering compared to rejecting rows on the key cell
+	auto const is_au = []( std::string_view country ) {
+		return country == "au";
+	};
+	daw::bench_n_test_mbs<num_runs>(
+	  "parse_csv_table then filter", data_sv.size( ),
+	  [&]( auto rng ) {
+		  auto result = std::vector<world_cities_pop>( );
+		  for( auto &row :
+		       daw::text_data::parse_csv_table<world_cities_pop>( rng ) ) {
+			  if( is_au( row.country ) ) {
+				  result.push_back( row );
+			  }
+		  }
+		  daw::do_not_optimize( result );
+	  },
+	  data_sv );
+
+	daw::bench_n_test_mbs<num_runs>(
+	  "parse_csv_table_if", data_sv.size( ),
+	  [&]( auto rng ) {
+		  daw::do_not_optimize(
+		    daw::text_data::parse_csv_table_if<world_cities_pop, 0>( rng,
+		                                                             is_au ) );
+	  },
+	  data_sv );
+
+	// Reading the coordinates of the rows of one country, parsing every cell
+	// of each row compared to parsing the cells that are accessed
+	using coords_iter_t = daw::text_data::csv_table_iterator<world_cities_coords>;
+	daw::bench_n_test_mbs<num_runs>(
+	  "csv_table_iterator coordinates", data_sv.size( ),
+	  [&]( auto rng ) {
+		  double sum = 0.0;
+		  for( auto it = coords_iter_t( rng ); it != coords_iter_t( ); ++it ) {
+			  if( is_au( it->country ) ) {
+				  sum += it->latitude + it->longitude;
+			  }
+		  }
+		  daw::do_not_optimize( sum );
+	  },
+	  data_sv );
+
+	using coords_view_iter_t =
+	  daw::text_data::csv_row_view_iterator<world_cities_coords>;
+	daw::bench_n_test_mbs<num_runs>(
+	  "csv_row_view_iterator coordinates", data_sv.size( ),
+	  [&]( auto rng ) {
+		  double sum = 0.0;
+		  for( auto it = coords_view_iter_t( rng ); it != coords_view_iter_t( );
+		       ++it ) {
+			  if( is_au( it->cell<0>( ) ) ) {
+				  sum += it->get<2>( ) + it->get<3>( );
+			  }
+		  }
+		  daw::do_not_optimize( sum );
+	  },
+	  data_sv );
+
+	daw::bench_n_test_mbs<num_runs>(
+	  "parse_csv_table runtime_dialect", data_sv.size( ),
+	  []( auto rng ) {
+		  daw::do_not_optimize( daw::text_data::parse_csv_table<world_cities_pop>(
+		    rng, daw::text_data::runtime_dialect{} ) );
+	  },
+	  data_sv );
+
+	daw::bench_n_test_mbs<num_runs>(
+	  "parse_csv_table ignored columns", data_sv.size( ),
+	  []( auto rng ) {
+		  daw::do_not_optimize(
+		    daw::text_data::parse_csv_table<world_cities_latitude>( rng ) );
+	  },
+	  data_sv );
+
+	daw::bench_n_test_mbs<num_runs>(
+	  "parse_csv_table positional columns", data_sv.size( ),
+	  []( auto rng ) {
+		  daw::do_not_optimize(
+		    daw::text_data::parse_csv_table<world_cities_latitude_at>( rng ) );
+	  },
+	  data_sv );
+
+	using names_arena_t =
+	  daw::text_data::arena_vector<world_cities_names_arena>;
+	daw::bench_n_test_mbs<num_runs>(
+	  "parse_csv_table std::string", data_sv.size( ),
+	  []( auto rng ) {
+		  daw::do_not_optimize(
+		    daw::text_data::parse_csv_table<world_cities_names>( rng ) );
+	  },
+	  data_sv );
+
+	daw::bench_n_test_mbs<num_runs>(
+	  "parse_csv_table text_string_arena", data_sv.size( ),
+	  []( auto rng ) {
+		  daw::do_not_optimize(
+		    daw::text_data::parse_csv_table<world_cities_names_arena,
+		                                    names_arena_t>( rng ) );
+	  },
+	  data_sv );
+
+	daw::bench_n_test_mbs<num_runs>(
+	  "parse_csv_table text_string_view", data_sv.size( ),
+	  []( auto rng ) {
+		  daw::do_not_optimize(
+		    daw::text_data::parse_csv_table<
+		      world_cities_names_view,
+		      daw::text_data::arena_vector<world_cities_names_view>>( rng ) );
+	  },
+	  data_sv );
+
+	daw::bench_n_test_mbs<num_runs>(
+	  "mapped_csv_table::parse", data_sv.size( ),
+	  [&table]( auto ) { daw::do_not_optimize( table.parse( ) ); }, data_sv );
+
+	daw::bench_n_test_mbs<num_runs>(
+	  "parse_csv_table_parallel", data_sv.size( ),
+	  []( auto rng ) {
+		  daw::do_not_optimize(
+		    daw::text_data::parse_csv_table_parallel<world_cities_pop>( rng ) );
+	  },
+	  data_sv );
+
+	daw::bench_n_test_mbs<num_runs>(
+	  "parse_csv_columns", data_sv.size( ),
+	  []( auto rng ) {
+		  daw::do_not_optimize(
+		    daw::text_data::parse_csv_columns<world_cities_pop>( rng ) );
+	  },
+	  data_sv );
+
+	auto const rows = daw::text_data::parse_csv_table<world_cities_pop>( data_sv );
+	std::vector<std::string_view> coords{};
+	coords.reserve( rows.size( ) * 2U );
+	std::size_t coords_size = 0;
+	for( auto const &row : rows ) {
+		coords.push_back( row.latitude );
+		coords.push_back( row.longitude );
+		coords_size += row.latitude.size( ) + row.longitude.size( );
+	}
+
+	daw::bench_n_test_mbs<num_runs>(
+	  "latitude/longitude strtod", coords_size,
+	  []( auto const &cells ) {
+		  double sum = 0.0;
+		  for( auto cell : cells ) {
+			  // The cells are not NUL terminated, strtod stops at the delimiter
+			  sum += std::strtod( cell.data( ), nullptr );
+		  }
+		  daw::do_not_optimize( sum );
+	  },
+	  coords );
+
+	daw::bench_n_test_mbs<num_runs>(
+	  "latitude/longitude parse_real", coords_size,
+	  []( auto const &cells ) {
+		  double sum = 0.0;
+		  for( auto cell : cells ) {
+			  sum += daw::text_data::text_table_details::parse_real<double>(
+			           cell.data( ), cell.data( ) + cell.size( ) )
+			           .value;
+		  }
+		  daw::do_not_optimize( sum );
+	  },
+	  coords );
+
+	auto const coord_rows =
+	  daw::text_data::parse_csv_table<world_cities_coords>( data_sv );
+	std::size_t written_size = 0;
+	auto count_sink = [&]( std::string_view out ) {
+		written_size += out.size( );
+	};
+	daw::text_data::write_csv_table<world_cities_coords>( coord_rows,
+	                                                      count_sink );
+	auto const output_size = written_size;
+
+	daw::bench_n_test_mbs<num_runs>(
+	  "write_csv_table", output_size,
+	  [&]( auto const &table_rows ) {
+		  written_size = 0;
+		  daw::text_data::write_csv_table<world_cities_coords>( table_rows,
+		                                                        count_sink );
+		  daw::do_not_optimize( written_size );
+	  },
+	  coord_rows );
+
+	daw::bench_n_test_mbs<num_runs>(
+	  "write_csv_table_parallel", output_size,
+	  [&]( auto const &table_rows ) {
+		  written_size = 0;
+		  daw::text_data::write_csv_table_parallel<world_cities_coords>(
+		    table_rows, count_sink );
+		  daw::do_not_optimize( written_size );
+	  },
+	  coord_rows );
+
+	// The same output formatted by hand
+	daw::bench_n_test_mbs<num_runs>(
+	  "snprintf writer", output_size,
+	  [&]( auto const &table_rows ) {
+		  auto buff = std::vector<char>( 1024U * 1024U );
+		  std::size_t pos = 0;
+		  written_size = 0;
+		  for( auto const &row : table_rows ) {
+			  if( buff.size( ) - pos < 1024U ) {
+				  count_sink( std::string_view( buff.data( ), pos ) );
+				  pos = 0;
+			  }
+			  pos += static_cast<std::size_t>( std::snprintf(
+			    buff.data( ) + pos, buff.size( ) - pos, "%.*s,%.*s,%.17g,%.17g\n",
+			    static_cast<int>( row.country.size( ) ), row.country.data( ),
+			    static_cast<int>( row.city.size( ) ), row.city.data( ),
+			    row.latitude, row.longitude ) );
+		  }
+		  count_sink( std::string_view( buff.data( ), pos ) );
+		  daw::do_not_optimize( written_size );
+	  },
+	  coord_rows );
+
 	std::size_t row_count = 0;
 	daw::bench_n_test_mbs<num_runs>(
 	  "row_count", data_sv.size( ),
-	  [&]( auto rng ) { row_count = daw::text_data::table_row_count( rng ); },
+	  [&]( auto rng ) {
+		  row_count = daw::text_data::table_row_count( rng );
+		  daw::do_not_optimize( row_count );
+	  },
+	  data_sv );
+
+	daw::bench_n_test_mbs<num_runs>(
+	  "row_count_parallel", data_sv.size( ),
+	  [&]( auto rng ) {
+		  row_count = daw::text_data::table_row_count_parallel( rng );
+		  daw::do_not_optimize( row_count );
+	  },
 	  data_sv );
 
 	daw::do_not_optimize( row_count );
+
+	auto const index = daw::text_data::build_row_index( data_sv );
+	daw::bench_n_test_mbs<num_runs>(
+	  "build_row_index", data_sv.size( ),
+	  []( auto rng ) {
+		  daw::do_not_optimize( daw::text_data::build_row_index( rng ) );
+	  },
+	  data_sv );
+
+	// Reaching the last row by skipping every row before it compared to
+	// starting from the nearest indexed row
+	auto const last_row = index.row_count( ) - 1U;
+	daw::bench_n_test_mbs<num_runs>(
+	  "iterate to last row", data_sv.size( ),
+	  [&]( auto rng ) {
+		  auto it = iter_t( rng );
+		  for( std::size_t n = 0; n < last_row; ++n ) {
+			  ++it;
+		  }
+		  daw::do_not_optimize( it->city );
+	  },
+	  data_sv );
+
+	daw::bench_n_test_mbs<num_runs>(
+	  "seek_row to last row", data_sv.size( ),
+	  [&]( auto rng ) {
+		  auto it = iter_t( rng );
+		  it.seek_row( index, last_row );
+		  daw::do_not_optimize( it->city );
+	  },
+	  data_sv );
+
+	daw::bench_n_test_mbs<num_runs>(
+	  "parse_csv_table_parallel row_index", data_sv.size( ),
+	  [&]( auto rng ) {
+		  daw::do_not_optimize(
+		    daw::text_data::parse_csv_table_parallel<world_cities_pop>( rng,
+		                                                                index ) );
+	  },
+	  data_sv );
 }